@@ -23,6 +23,7 @@
 * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
 #include "openzwavebackend.h"
+#include "openzwavesnapshot.h"
 
 #include <Options.h>
 #include <Manager.h>
@@ -31,17 +32,44 @@
 #include <Utils.h>
 
 #include <QDir>
+#include <QSaveFile>
+#include <QTextStream>
+
+#include <cstdlib>
 
 #include <nymeasettings.h>
 #include <loggingcategories.h>
 NYMEA_LOGGING_CATEGORY(dcOpenZWave, "OpenZWaveBackend")
 
 OpenZWaveBackend::OpenZWaveBackend(QObject *parent)
-    : ZWaveBackend(parent)
+    : ZWaveBackend(parent),
+      m_storagePath(NymeaSettings::storagePath() + "/openzwave/")
 {
     qRegisterMetaType<OpenZWaveBackend::NotificationCode>();
     qRegisterMetaType<OpenZWaveBackend::ControllerCommand>();
     qRegisterMetaType<OpenZWaveBackend::ControllerState>();
+
+    m_clock.start();
+
+    connect(&m_valueCoalescer, &OpenZWaveValueCoalescer::valueReady, this, &OpenZWaveBackend::valueChanged);
+    connect(&m_trafficScheduler, &OpenZWaveTrafficScheduler::interactiveTrafficChanged, this, &OpenZWaveBackend::onInteractiveTrafficChanged);
+
+    connect(&m_dispatchStatisticsDumpTimer, &QTimer::timeout, this, &OpenZWaveBackend::dumpDispatchStatistics);
+    connect(&m_nodeStatisticsTimer, &QTimer::timeout, this, &OpenZWaveBackend::collectNodeStatistics);
+    m_nodeStatisticsTimer.start(NodeStatisticsInterval);
+    connect(&m_driverStatisticsTimer, &QTimer::timeout, this, &OpenZWaveBackend::sampleDriverStatistics);
+    m_driverStatisticsTimer.start(DriverStatisticsInterval);
+    connect(&m_healTimer, &QTimer::timeout, this, &OpenZWaveBackend::scheduleHeals);
+    m_healTimer.start(HealCheckInterval);
+
+    m_managerIdleTimer.setSingleShot(true);
+    m_managerIdleTimer.setInterval(ManagerIdleTimeout);
+    connect(&m_managerIdleTimer, &QTimer::timeout, this, [this](){
+        if (m_networks.isEmpty() && m_manager) {
+            qCDebug(dcOpenZWave()) << "No networks running any more, shutting down OpenZWave";
+            deinitOZW();
+        }
+    });
 }
 
 OpenZWaveBackend::~OpenZWaveBackend()
@@ -50,96 +78,211 @@ OpenZWaveBackend::~OpenZWaveBackend()
         m_manager->Destroy();
         m_options->Destroy();
     }
+    qDeleteAll(m_networks);
 }
 
 bool OpenZWaveBackend::startNetwork(const QUuid &networkUuid, const QString &serialPort, const QString &networkKey)
 {
+    qint64 started = m_clock.elapsed();
+    m_managerIdleTimer.stop();
+    if (m_options && networkKey != m_networkKey) {
+        bool othersRunning = false;
+        foreach (const QUuid &uuid, m_networks.keys()) {
+            othersRunning |= uuid != networkUuid;
+        }
+        if (othersRunning) {
+            qCWarning(dcOpenZWave()) << "OpenZWave does not support different network keys per network";
+        } else {
+            // The key is an option of the Manager, only kept running for a faster restart
+            qCDebug(dcOpenZWave()) << "Network key changed, restarting OpenZWave";
+            deinitOZW();
+        }
+    }
+    bool warmStart = m_options != nullptr;
     if (!m_options) {
         initOZW(networkKey);
-    } else {
-        qCWarning(dcOpenZWave()) << "OpenZWave does not support different network keys per network";
-    }
-    if (m_manager->AddDriver(serialPort.toStdString())) {
-        m_pendingNetworkSetups.append(networkUuid);
-        m_serialPorts.insert(networkUuid, serialPort);
-        return true;
+        qCDebug(dcOpenZWave()) << "OpenZWave initialized in" << m_clock.elapsed() - started << "ms";
+    }
+    OpenZWaveNetwork *network = m_networks.value(networkUuid);
+    bool created = !network;
+    if (created) {
+        network = new OpenZWaveNetwork(networkUuid, serialPort);
+        m_networks.insert(networkUuid, network);
+        loadSnapshot(network);
+    }
+    network->serialPort = serialPort;
+    network->driverAdded = started;
+    network->warmStart = warmStart;
+    if (!addDriver(network)) {
+        if (created) {
+            m_networks.remove(networkUuid);
+            delete network;
+        }
+        return false;
     }
-    return false;
+    return true;
 }
 
 bool OpenZWaveBackend::stopNetwork(const QUuid &networkUuid)
 {
-    if (!m_serialPorts.contains(networkUuid)) {
+    OpenZWaveNetwork *network = m_networks.take(networkUuid);
+    if (!network) {
         qCWarning(dcOpenZWave()) << "No network found for network uuid:" << networkUuid.toString();
         return false;
     }
-    qCDebug(dcOpenZWave()) << "Removing driver:" << m_serialPorts.value(networkUuid);
-    bool status = m_manager->RemoveDriver(m_serialPorts.value(networkUuid).toStdString());
+    qCDebug(dcOpenZWave()) << "Removing driver:" << network->serialPort;
+#ifndef OZW_16
+    m_deferredNetworkSetups.removeAll(networkUuid);
+#endif
+    finishNetworkSetup(networkUuid);
+    bool status = m_manager->RemoveDriver(network->serialPort.toStdString());
 
-    m_serialPorts.remove(networkUuid);
-    m_homeIds.remove(networkUuid);
+    saveSnapshot(network);
+    m_networksByHomeId.remove(network->homeId);
+    m_valueCoalescer.dropNetwork(networkUuid);
+    finishPendingWrites(network->writeTracker.takeAll(), ZWave::ZWaveErrorBackendError);
+    delete network;
 
-    if (m_serialPorts.isEmpty()) {
-        deinitOZW();
+    if (m_networks.isEmpty()) {
+        m_managerIdleTimer.start();
     }
     return status;
 }
 
+bool OpenZWaveBackend::restartNetwork(const QUuid &networkUuid)
+{
+    OpenZWaveNetwork *network = m_networks.value(networkUuid);
+    if (!network || !m_manager) {
+        qCWarning(dcOpenZWave()) << "No network found for network uuid:" << networkUuid.toString();
+        return false;
+    }
+    qCDebug(dcOpenZWave()) << "Restarting driver:" << network->serialPort;
+    m_pendingNetworkSetups.removeAll(networkUuid);
+    m_manager->RemoveDriver(network->serialPort.toStdString());
+    m_networksByHomeId.remove(network->homeId);
+    m_valueCoalescer.dropNetwork(networkUuid);
+    finishPendingWrites(network->writeTracker.takeAll(), ZWave::ZWaveErrorBackendError);
+    network->driverMonitor.reset();
+
+    // Everything known so far is handled like a snapshot, the driver will add it again
+    network->snapshotHomeId = network->homeId;
+    network->homeId = 0;
+    for (QHash<quint8, QHash<quint64, ZWaveValue> >::const_iterator it = network->values.constBegin(); it != network->values.constEnd(); ++it) {
+        network->snapshotNodes.insert(it.key());
+        foreach (quint64 valueId, it.value().keys()) {
+            network->snapshotValues.insert(valueId);
+        }
+    }
+
+    network->driverAdded = m_clock.elapsed();
+    network->warmStart = true;
+    return addDriver(network);
+}
+
+bool OpenZWaveBackend::addDriver(OpenZWaveNetwork *network)
+{
+    m_pendingNetworkSetups.removeAll(network->networkUuid);
+#ifndef OZW_16
+    // Before 1.6 a failing driver doesn't tell its serial port, so drivers are added one after the other
+    if (!m_pendingNetworkSetups.isEmpty()) {
+        qCDebug(dcOpenZWave()) << "Waiting for another network to start up before adding driver:" << network->serialPort;
+        m_deferredNetworkSetups.removeAll(network->networkUuid);
+        m_deferredNetworkSetups.append(network->networkUuid);
+        return true;
+    }
+#endif
+    if (!m_manager->AddDriver(network->serialPort.toStdString())) {
+        return false;
+    }
+    m_pendingNetworkSetups.append(network->networkUuid);
+    return true;
+}
+
+void OpenZWaveBackend::finishNetworkSetup(const QUuid &networkUuid)
+{
+    m_pendingNetworkSetups.removeAll(networkUuid);
+#ifndef OZW_16
+    while (m_pendingNetworkSetups.isEmpty() && !m_deferredNetworkSetups.isEmpty()) {
+        OpenZWaveNetwork *network = m_networks.value(m_deferredNetworkSetups.takeFirst());
+        if (network && !addDriver(network)) {
+            emit networkFailed(network->networkUuid);
+        }
+    }
+#endif
+}
+
+OpenZWaveBackend::StartupTimes OpenZWaveBackend::coldStartTimes() const
+{
+    return m_coldStartTimes;
+}
+
+OpenZWaveBackend::StartupTimes OpenZWaveBackend::warmStartTimes() const
+{
+    return m_warmStartTimes;
+}
+
 quint32 OpenZWaveBackend::homeId(const QUuid &networkUuid)
 {
-    return m_homeIds.value(networkUuid);
+    OpenZWaveNetwork *network = m_networks.value(networkUuid);
+    return network ? network->homeId : 0;
 }
 
 quint8 OpenZWaveBackend::controllerNodeId(const QUuid &networkUuid)
 {
-    if (!m_homeIds.contains(networkUuid)) {
+    OpenZWaveNetwork *network = startedNetwork(networkUuid);
+    if (!network) {
         return false;
     }
-    return m_manager->GetControllerNodeId(m_homeIds.value(networkUuid));
+    return m_manager->GetControllerNodeId(network->homeId);
 }
 
 bool OpenZWaveBackend::isPrimaryController(const QUuid &networkUuid)
 {
-    if (!m_homeIds.contains(networkUuid)) {
+    OpenZWaveNetwork *network = startedNetwork(networkUuid);
+    if (!network) {
         return false;
     }
-    return m_manager->IsPrimaryController(m_homeIds.value(networkUuid));
+    return m_manager->IsPrimaryController(network->homeId);
 }
 
 bool OpenZWaveBackend::isStaticUpdateController(const QUuid &networkUuid)
 {
-    if (!m_homeIds.contains(networkUuid)) {
+    OpenZWaveNetwork *network = startedNetwork(networkUuid);
+    if (!network) {
         return false;
     }
-    return m_manager->IsStaticUpdateController(m_homeIds.value(networkUuid));
+    return m_manager->IsStaticUpdateController(network->homeId);
 }
 
 bool OpenZWaveBackend::isBridgeController(const QUuid &networkUuid)
 {
-    if (!m_homeIds.contains(networkUuid)) {
+    OpenZWaveNetwork *network = startedNetwork(networkUuid);
+    if (!network) {
         return false;
     }
-    return m_manager->IsBridgeController(m_homeIds.value(networkUuid));
+    return m_manager->IsBridgeController(network->homeId);
 }
 
 bool OpenZWaveBackend::factoryResetNetwork(const QUuid &networkUuid)
 {
-    if (!m_homeIds.contains(networkUuid)) {
+    OpenZWaveNetwork *network = startedNetwork(networkUuid);
+    if (!network) {
         return false;
     }
     m_pendingNetworkSetups.append(networkUuid);
-    m_manager->ResetController(m_homeIds.value(networkUuid));
+    m_manager->ResetController(network->homeId);
     return true;
 }
 
 ZWaveReply *OpenZWaveBackend::addNode(const QUuid &networkUuid, bool useSecurity)
 {
     ZWaveReply *reply = new ZWaveReply(this);
-    if (!m_homeIds.contains(networkUuid)) {
+    OpenZWaveNetwork *network = startedNetwork(networkUuid);
+    if (!network) {
         finishReply(reply, ZWave::ZWaveErrorNetworkUuidNotFound);
         return reply;
     }
-    quint32 homeId = m_homeIds.value(networkUuid);
+    quint32 homeId = network->homeId;
     if (m_pendingControllerCommands.contains(homeId)) {
         emit reply->finished(ZWave::ZWaveErrorInUse);
         return reply;
@@ -147,7 +290,7 @@ ZWaveReply *OpenZWaveBackend::addNode(const QUuid &networkUuid, bool useSecurity
 #ifndef OZW_16
     m_controllerCommand = ControllerCommandAddDevice;
 #endif
-    bool status = m_manager->AddNode(m_homeIds.value(networkUuid), useSecurity);
+    bool status = m_manager->AddNode(network->homeId, useSecurity);
     if (!status) {
         finishReply(reply, ZWave::ZWaveErrorBackendError);
         return reply;
@@ -163,16 +306,17 @@ ZWaveReply *OpenZWaveBackend::addNode(const QUuid &networkUuid, bool useSecurity
 ZWaveReply *OpenZWaveBackend::removeNode(const QUuid &networkUuid)
 {
     ZWaveReply *reply = new ZWaveReply(this);
-    if (!m_homeIds.contains(networkUuid)) {
+    OpenZWaveNetwork *network = startedNetwork(networkUuid);
+    if (!network) {
         finishReply(reply, ZWave::ZWaveErrorNetworkUuidNotFound);
         return reply;
     }
-    quint32 homeId = m_homeIds.value(networkUuid);
+    quint32 homeId = network->homeId;
     if (m_pendingControllerCommands.contains(homeId)) {
         finishReply(reply, ZWave::ZWaveErrorInUse);
         return reply;
     }
-    qCDebug(dcOpenZWave()) << "Starting node removal procedure for network" << m_homeIds.value(networkUuid);
+    qCDebug(dcOpenZWave()) << "Starting node removal procedure for network" << network->homeId;
 #ifndef OZW_16
     m_controllerCommand = ControllerCommandRemoveDevice;
 #endif
@@ -192,18 +336,19 @@ ZWaveReply *OpenZWaveBackend::removeNode(const QUuid &networkUuid)
 ZWaveReply *OpenZWaveBackend::removeFailedNode(const QUuid &networkUuid, quint8 nodeId)
 {
     ZWaveReply *reply = new ZWaveReply(this);
-    if (!m_homeIds.contains(networkUuid)) {
+    OpenZWaveNetwork *network = startedNetwork(networkUuid);
+    if (!network) {
         finishReply(reply, ZWave::ZWaveErrorNetworkUuidNotFound);
         return reply;
     }
-    quint32 homeId = m_homeIds.value(networkUuid);
+    quint32 homeId = network->homeId;
     if (m_pendingControllerCommands.contains(homeId)) {
         emit reply->finished(ZWave::ZWaveErrorInUse);
         return reply;
     }
-    qCDebug(dcOpenZWave()) << "Removing failed node" << nodeId << "from network" << m_homeIds.value(networkUuid);
+    qCDebug(dcOpenZWave()) << "Removing failed node" << nodeId << "from network" << network->homeId;
 
-    bool status = m_manager->RemoveFailedNode(m_homeIds.value(networkUuid), nodeId);
+    bool status = m_manager->RemoveFailedNode(network->homeId, nodeId);
     if (!status) {
         finishReply(reply, ZWave::ZWaveErrorBackendError);
         return reply;
@@ -219,170 +364,467 @@ ZWaveReply *OpenZWaveBackend::removeFailedNode(const QUuid &networkUuid, quint8
 ZWaveReply *OpenZWaveBackend::cancelPendingOperation(const QUuid &networkUuid)
 {
     ZWaveReply *reply = new ZWaveReply(this);
-    if (!m_homeIds.contains(networkUuid)) {
+    OpenZWaveNetwork *network = startedNetwork(networkUuid);
+    if (!network) {
         finishReply(reply, ZWave::ZWaveErrorNetworkUuidNotFound);
         return reply;
     }
 
     qCDebug(dcOpenZWave()) << "Cancelling pending controller command";
-    bool status = m_manager->CancelControllerCommand(m_homeIds.value(networkUuid));
+    bool status = m_manager->CancelControllerCommand(network->homeId);
     finishReply(reply, status ? ZWave::ZWaveErrorNoError : ZWave::ZWaveErrorInUse);
     return reply;
 }
 
+QString OpenZWaveBackend::snapshotFileName(const QUuid &networkUuid) const
+{
+    return m_storagePath + networkUuid.toString().remove('{').remove('}') + ".snapshot";
+}
+
+void OpenZWaveBackend::loadSnapshot(OpenZWaveNetwork *network)
+{
+    network->snapshotHomeId = OpenZWaveSnapshot::load(snapshotFileName(network->networkUuid), network);
+    if (network->snapshotHomeId == 0) {
+        return;
+    }
+    for (int nodeId = 1; nodeId <= OpenZWaveNetwork::MaxNodes; nodeId++) {
+        if (network->nodes[nodeId - 1].valid || network->values.contains(nodeId)) {
+            network->snapshotNodes.insert(nodeId);
+        }
+    }
+    qCInfo(dcOpenZWave()) << "Presenting" << network->snapshotNodes.count() << "nodes of network" << network->networkUuid.toString() << "from snapshot";
+    foreach (quint8 nodeId, network->snapshotNodes) {
+        emit nodeAdded(network->networkUuid, nodeId);
+        foreach (const ZWaveValue &value, network->values.value(nodeId)) {
+            network->snapshotValues.insert(value.id());
+            emit valueAdded(network->networkUuid, nodeId, value);
+        }
+    }
+}
+
+void OpenZWaveBackend::saveSnapshot(OpenZWaveNetwork *network)
+{
+    if (network->homeId == 0) {
+        return;
+    }
+    if (!OpenZWaveSnapshot::save(snapshotFileName(network->networkUuid), network)) {
+        qCWarning(dcOpenZWave()) << "Cannot write snapshot of network" << network->networkUuid.toString();
+    }
+}
+
+void OpenZWaveBackend::discardSnapshot(OpenZWaveNetwork *network)
+{
+    // Whatever OpenZWave didn't confirm by now is gone
+    for (QHash<quint8, QHash<quint64, ZWaveValue> >::iterator it = network->values.begin(); it != network->values.end(); ++it) {
+        foreach (quint64 valueId, it.value().keys()) {
+            if (network->snapshotValues.contains(valueId)) {
+                it.value().remove(valueId);
+                emit valueRemoved(network->networkUuid, it.key(), valueId);
+            }
+        }
+    }
+    foreach (quint8 nodeId, network->snapshotNodes) {
+        qCInfo(dcOpenZWave()) << "Node" << nodeId << "from snapshot is not in network" << network->networkUuid.toString() << "any more";
+        network->values.remove(nodeId);
+        network->nodeIds.remove(nodeId);
+        network->invalidateNodeInfo(nodeId);
+        emit nodeRemoved(network->networkUuid, nodeId);
+    }
+    network->snapshotHomeId = 0;
+    network->snapshotNodes.clear();
+    network->snapshotValues.clear();
+}
+
+OpenZWaveNetwork *OpenZWaveBackend::startedNetwork(const QUuid &networkUuid) const
+{
+    OpenZWaveNetwork *network = m_networks.value(networkUuid);
+    if (!network || network->homeId == 0) {
+        return nullptr;
+    }
+    return network;
+}
+
 bool OpenZWaveBackend::isNodeAwake(const QUuid &networkUuid, quint8 nodeId)
 {
-    if (!m_homeIds.contains(networkUuid)) {
+    OpenZWaveNetwork *network = startedNetwork(networkUuid);
+    if (!network) {
         return false;
     }
-    return m_manager->IsNodeAwake(m_homeIds.value(networkUuid), nodeId);
+    return m_manager->IsNodeAwake(network->homeId, nodeId);
 }
 
 bool OpenZWaveBackend::isNodeFailed(const QUuid &networkUuid, quint8 nodeId)
 {
-    if (!m_homeIds.contains(networkUuid)) {
+    OpenZWaveNetwork *network = startedNetwork(networkUuid);
+    if (!network) {
         return false;
     }
-    return m_manager->IsNodeFailed(m_homeIds.value(networkUuid), nodeId);
+    return m_manager->IsNodeFailed(network->homeId, nodeId);
 }
 
 QString OpenZWaveBackend::nodeName(const QUuid &networkUuid, quint8 nodeId)
 {
-    if (!m_homeIds.contains(networkUuid)) {
+    const OpenZWaveNodeInfo *info = nodeInfo(networkUuid, nodeId);
+    if (!info) {
         return QString();
     }
-    return QString::fromStdString(m_manager->GetNodeName(m_homeIds.value(networkUuid), nodeId));
+    return info->name;
 }
 
 ZWaveNode::ZWaveNodeType OpenZWaveBackend::nodeType(const QUuid &networkUuid, quint8 nodeId)
 {
-    if (!m_homeIds.contains(networkUuid)) {
+    const OpenZWaveNodeInfo *info = nodeInfo(networkUuid, nodeId);
+    if (!info) {
         return ZWaveNode::ZWaveNodeTypeUnknown;
     }
-    return static_cast<ZWaveNode::ZWaveNodeType>(m_manager->GetNodeBasic(m_homeIds.value(networkUuid), nodeId));
+    return static_cast<ZWaveNode::ZWaveNodeType>(info->basic);
 }
 
 ZWaveNode::ZWaveDeviceType OpenZWaveBackend::nodeDeviceType(const QUuid &networkUuid, quint8 nodeId)
 {
-    if (!m_homeIds.contains(networkUuid)) {
+    const OpenZWaveNodeInfo *info = nodeInfo(networkUuid, nodeId);
+    if (!info) {
         return ZWaveNode::ZWaveDeviceTypeUnknown;
     }
-    return static_cast<ZWaveNode::ZWaveDeviceType>(m_manager->GetNodeDeviceType(m_homeIds.value(networkUuid), nodeId));
+    return static_cast<ZWaveNode::ZWaveDeviceType>(info->deviceType);
 }
 
 ZWaveNode::ZWaveNodeRole OpenZWaveBackend::nodeRole(const QUuid &networkUuid, quint8 nodeId)
 {
-    if (!m_homeIds.contains(networkUuid)) {
+    const OpenZWaveNodeInfo *info = nodeInfo(networkUuid, nodeId);
+    if (!info) {
         return ZWaveNode::ZWaveNodeRoleUnknown;
     }
-    return static_cast<ZWaveNode::ZWaveNodeRole>(m_manager->GetNodeRole(m_homeIds.value(networkUuid), nodeId));
+    return static_cast<ZWaveNode::ZWaveNodeRole>(info->role);
 }
 
 quint8 OpenZWaveBackend::nodeSecurityMode(const QUuid &networkUuid, quint8 nodeId)
 {
-    if (!m_homeIds.contains(networkUuid)) {
+    const OpenZWaveNodeInfo *info = nodeInfo(networkUuid, nodeId);
+    if (!info) {
         return ZWaveNode::ZWaveNodeRoleUnknown;
     }
-    return static_cast<ZWaveNode::ZWaveNodeRole>(m_manager->GetNodeSecurity(m_homeIds.value(networkUuid), nodeId));
+    return info->security;
 }
 
 ZWaveNode::ZWavePlusDeviceType OpenZWaveBackend::nodePlusDeviceType(const QUuid &networkUuid, quint8 nodeId)
 {
-    if (!m_homeIds.contains(networkUuid)) {
+    const OpenZWaveNodeInfo *info = nodeInfo(networkUuid, nodeId);
+    if (!info) {
         return ZWaveNode::ZWavePlusDeviceTypeUnknown;
     }
-    return static_cast<ZWaveNode::ZWavePlusDeviceType>(m_manager->GetNodePlusType(m_homeIds.value(networkUuid), nodeId));
+    return static_cast<ZWaveNode::ZWavePlusDeviceType>(info->plusType);
 }
 
 bool OpenZWaveBackend::nodeIsSecureDevice(const QUuid &networkUuid, quint8 nodeId)
 {
-    if (!m_homeIds.contains(networkUuid)) {
+    const OpenZWaveNodeInfo *info = nodeInfo(networkUuid, nodeId);
+    if (!info) {
         return false;
     }
-
-    bool secured;
-    OpenZWave::ValueID valueId(m_homeIds.value(networkUuid), nodeId, OpenZWave::ValueID::ValueGenre_System, 0x98, 0, 0, OpenZWave::ValueID::ValueType_Bool);
-    try {
-        m_manager->GetValueAsBool(valueId, &secured);
-    } catch (const OpenZWave::OZWException &e) {
-        secured = false;
-    }
-    return secured;
+    return info->secure;
 }
 
 bool OpenZWaveBackend::nodeIsBeamingDevice(const QUuid &networkUuid, quint8 nodeId)
 {
-    if (!m_homeIds.contains(networkUuid)) {
+    const OpenZWaveNodeInfo *info = nodeInfo(networkUuid, nodeId);
+    if (!info) {
         return false;
     }
-    return m_manager->IsNodeBeamingDevice(m_homeIds.value(networkUuid), nodeId);
+    return info->beaming;
 }
 
 quint16 OpenZWaveBackend::nodeManufacturerId(const QUuid &networkUuid, quint8 nodeId)
 {
-    if (!m_homeIds.contains(networkUuid)) {
+    const OpenZWaveNodeInfo *info = nodeInfo(networkUuid, nodeId);
+    if (!info) {
         return 0;
     }
-    return QString::fromStdString(m_manager->GetNodeManufacturerId(m_homeIds.value(networkUuid), nodeId)).remove("0x").toUInt(nullptr, 16);
+    return info->manufacturerId;
 }
 
 QString OpenZWaveBackend::nodeManufacturerName(const QUuid &networkUuid, quint8 nodeId)
 {
-    if (!m_homeIds.contains(networkUuid)) {
+    const OpenZWaveNodeInfo *info = nodeInfo(networkUuid, nodeId);
+    if (!info) {
         return QString();
     }
-    return QString::fromStdString(m_manager->GetNodeManufacturerName(m_homeIds.value(networkUuid), nodeId));
+    return info->manufacturerName;
 }
 
 quint16 OpenZWaveBackend::nodeProductId(const QUuid &networkUuid, quint8 nodeId)
 {
-    if (!m_homeIds.contains(networkUuid)) {
+    const OpenZWaveNodeInfo *info = nodeInfo(networkUuid, nodeId);
+    if (!info) {
         return 0;
     }
-    return QString::fromStdString(m_manager->GetNodeProductId(m_homeIds.value(networkUuid), nodeId)).remove("0x").toUInt(nullptr, 16);
+    return info->productId;
 }
 
 QString OpenZWaveBackend::nodeProductName(const QUuid &networkUuid, quint8 nodeId)
 {
-    if (!m_homeIds.contains(networkUuid)) {
+    const OpenZWaveNodeInfo *info = nodeInfo(networkUuid, nodeId);
+    if (!info) {
         return QString();
     }
-    return QString::fromStdString(m_manager->GetNodeProductName(m_homeIds.value(networkUuid), nodeId));
+    return info->productName;
 }
 
 quint16 OpenZWaveBackend::nodeProductType(const QUuid &networkUuid, quint8 nodeId)
 {
-    if (!m_homeIds.contains(networkUuid)) {
+    const OpenZWaveNodeInfo *info = nodeInfo(networkUuid, nodeId);
+    if (!info) {
         return 0;
     }
-    return QString::fromStdString(m_manager->GetNodeProductType(m_homeIds.value(networkUuid), nodeId)).remove("0x").toUInt(nullptr, 16);
+    return info->productType;
 }
 
 quint8 OpenZWaveBackend::nodeVersion(const QUuid &networkUuid, quint8 nodeId)
 {
-    if (!m_homeIds.contains(networkUuid)) {
+    const OpenZWaveNodeInfo *info = nodeInfo(networkUuid, nodeId);
+    if (!info) {
         return 0;
     }
-    return m_manager->GetNodeVersion(m_homeIds.value(networkUuid), nodeId);
+    return info->version;
 }
 
 bool OpenZWaveBackend::nodeIsZWavePlus(const QUuid &networkUuid, quint8 nodeId)
 {
-    if (!m_homeIds.contains(networkUuid)) {
+    const OpenZWaveNodeInfo *info = nodeInfo(networkUuid, nodeId);
+    if (!info) {
         return false;
     }
-    return m_manager->IsNodeZWavePlus(m_homeIds.value(networkUuid), nodeId);
+    return info->zwavePlus;
+}
+
+ZWaveValue OpenZWaveBackend::value(const QUuid &networkUuid, quint8 nodeId, quint64 valueId) const
+{
+    OpenZWaveNetwork *network = m_networks.value(networkUuid);
+    if (!network) {
+        return ZWaveValue();
+    }
+    return network->values.value(nodeId).value(valueId);
+}
+
+OpenZWaveValueMetadata OpenZWaveBackend::valueMetadata(const QUuid &networkUuid, quint64 valueId) const
+{
+    OpenZWaveNetwork *network = startedNetwork(networkUuid);
+    if (!network) {
+        return OpenZWaveValueMetadata();
+    }
+    return network->metadata.value(valueId);
 }
 
 bool OpenZWaveBackend::setValue(const QUuid &networkUuid, quint8 nodeId, const ZWaveValue &value)
 {
-    Q_UNUSED(nodeId)
+    OpenZWaveNetwork *network = startedNetwork(networkUuid);
+    if (!network) {
+        return false;
+    }
+    if (isNodeSleeping(network, nodeId)) {
+        network->wakeUpQueue.add(nodeId, value);
+        recordEvent(OpenZWaveEventRing::EventWriteQueued, network->homeId, nodeId, value.id());
+        return true;
+    }
+    bool status = false;
+    m_trafficScheduler.schedule(OpenZWaveTrafficScheduler::PriorityInteractive, [this, network, &value, &status](){
+        status = writeValue(network, value);
+    });
+    return status;
+}
+
+ZWaveReply *OpenZWaveBackend::setValues(const QUuid &networkUuid, const QList<QPair<quint8, ZWaveValue> > &values)
+{
+    OpenZWaveValuesReply *reply = new OpenZWaveValuesReply(this);
+    OpenZWaveNetwork *network = startedNetwork(networkUuid);
+    if (!network) {
+        finishReply(reply, ZWave::ZWaveErrorNetworkUuidNotFound);
+        return reply;
+    }
+
+    // Group per node, keeping the order of first appearance of the nodes and values. Multiple writes to the
+    // same value of a node are collapsed into the last one.
+    QList<quint8> nodeIds;
+    QHash<quint8, QList<ZWaveValue> > nodeWrites;
+    QHash<QPair<quint8, quint64>, int> positions;
+    for (int i = 0; i < values.count(); i++) {
+        quint8 nodeId = values.at(i).first;
+        const ZWaveValue &value = values.at(i).second;
+        if (!nodeWrites.contains(nodeId)) {
+            nodeIds.append(nodeId);
+        }
+        QList<ZWaveValue> &writes = nodeWrites[nodeId];
+        QPair<quint8, quint64> key(nodeId, value.id());
+        QHash<QPair<quint8, quint64>, int>::const_iterator it = positions.constFind(key);
+        if (it != positions.constEnd()) {
+            writes[it.value()] = value;
+        } else {
+            positions.insert(key, writes.count());
+            writes.append(value);
+        }
+    }
+
+    bool success = true;
+    m_trafficScheduler.schedule(OpenZWaveTrafficScheduler::PriorityInteractive, [this, network, reply, &nodeIds, &nodeWrites, &success](){
+        foreach (quint8 nodeId, nodeIds) {
+            bool sleeping = isNodeSleeping(network, nodeId);
+            foreach (const ZWaveValue &value, nodeWrites.value(nodeId)) {
+                if (sleeping) {
+                    network->wakeUpQueue.add(nodeId, value);
+                    recordEvent(OpenZWaveEventRing::EventWriteQueued, network->homeId, nodeId, value.id());
+                    reply->addResult(nodeId, value.id(), ZWave::ZWaveErrorNoError);
+                    continue;
+                }
+                bool status = writeValue(network, value);
+                reply->addResult(nodeId, value.id(), status ? ZWave::ZWaveErrorNoError : ZWave::ZWaveErrorBackendError);
+                success &= status;
+            }
+        }
+    });
+
+    qCDebug(dcOpenZWave()) << "Wrote" << positions.count() << "values to" << nodeIds.count() << "nodes in network" << network->homeId << "(" << values.count() - positions.count() << "duplicates dropped)";
+    finishReply(reply, success ? ZWave::ZWaveErrorNoError : ZWave::ZWaveErrorBackendError);
+    return reply;
+}
+
+ZWaveReply *OpenZWaveBackend::setValueAsync(const QUuid &networkUuid, quint8 nodeId, const ZWaveValue &value)
+{
+    ZWaveReply *reply = new ZWaveReply(this);
+    OpenZWaveNetwork *network = startedNetwork(networkUuid);
+    if (!network) {
+        finishReply(reply, ZWave::ZWaveErrorNetworkUuidNotFound);
+        return reply;
+    }
+    bool status = false;
+    int messagesAhead = OpenZWaveWriteTracker::NotSent;
+    // Let MsgComplete notifications through before the write is sent, its own one might come in right away
+    m_trackedWrites.fetch_add(1, std::memory_order_relaxed);
+    if (isNodeSleeping(network, nodeId)) {
+        // Confirmed once the node woke up and reported the value
+        network->wakeUpQueue.add(nodeId, value);
+        recordEvent(OpenZWaveEventRing::EventWriteQueued, network->homeId, nodeId, value.id());
+        status = true;
+    } else {
+        m_trafficScheduler.schedule(OpenZWaveTrafficScheduler::PriorityInteractive, [this, network, &value, &status, &messagesAhead](){
+            status = writeValue(network, value);
+            // Includes the write itself, which rather delays a completion than completing a write early
+            messagesAhead = m_manager->GetSendQueueCount(network->homeId);
+        });
+    }
+    if (!status) {
+        updateTrackedWrites();
+        finishReply(reply, ZWave::ZWaveErrorBackendError);
+        return reply;
+    }
+
+    startReply(reply);
+    network->writeTracker.add(nodeId, value.id(), reply, m_clock.elapsed(), messagesAhead);
+    updateTrackedWrites();
+    connect(reply, &ZWaveReply::finished, this, [this, networkUuid, reply](){
+        OpenZWaveNetwork *network = m_networks.value(networkUuid);
+        if (network) {
+            network->writeTracker.remove(reply);
+        }
+        updateTrackedWrites();
+    });
+    return reply;
+}
 
+bool OpenZWaveBackend::refreshValue(const QUuid &networkUuid, quint8 nodeId, quint64 valueId)
+{
+    Q_UNUSED(nodeId)
 
-    if (!m_homeIds.contains(networkUuid)) {
+    if (!startedNetwork(networkUuid)) {
         return false;
     }
-    OpenZWave::ValueID valueId(m_homeIds.value(networkUuid), value.id());
+    m_trafficScheduler.schedule(OpenZWaveTrafficScheduler::PriorityRefresh, [this, networkUuid, valueId](){
+        OpenZWaveNetwork *network = startedNetwork(networkUuid);
+        if (!network) {
+            return;
+        }
+        try {
+            m_manager->RefreshValue(OpenZWave::ValueID(network->homeId, valueId));
+        } catch (const OpenZWave::OZWException &e) {
+            qCWarning(dcOpenZWave()) << "Error refreshing value:" << e.what();
+        }
+    });
+    return true;
+}
+
+QList<ZWaveValue> OpenZWaveBackend::pendingWrites(const QUuid &networkUuid, quint8 nodeId) const
+{
+    OpenZWaveNetwork *network = m_networks.value(networkUuid);
+    if (!network) {
+        return QList<ZWaveValue>();
+    }
+    return network->wakeUpQueue.pendingWrites(nodeId);
+}
+
+OpenZWaveWakeUpQueue::Statistics OpenZWaveBackend::wakeUpQueueStatistics(const QUuid &networkUuid) const
+{
+    OpenZWaveNetwork *network = m_networks.value(networkUuid);
+    if (!network) {
+        return OpenZWaveWakeUpQueue::Statistics();
+    }
+    return network->wakeUpQueue.statistics();
+}
+
+OpenZWaveTrafficScheduler *OpenZWaveBackend::trafficScheduler()
+{
+    return &m_trafficScheduler;
+}
+
+OpenZWavePollingEngine::Statistics OpenZWaveBackend::pollingStatistics(const QUuid &networkUuid) const
+{
+    OpenZWaveNetwork *network = m_networks.value(networkUuid);
+    if (!network) {
+        return OpenZWavePollingEngine::Statistics();
+    }
+    return network->pollingEngine.statistics();
+}
+
+OpenZWaveWriteTracker::Latency OpenZWaveBackend::writeLatency(const QUuid &networkUuid, quint8 nodeId) const
+{
+    OpenZWaveNetwork *network = m_networks.value(networkUuid);
+    if (!network) {
+        return OpenZWaveWriteTracker::Latency();
+    }
+    return network->writeTracker.latency(nodeId);
+}
+
+void OpenZWaveBackend::finishPendingWrites(const QList<ZWaveReply *> &replies, ZWave::ZWaveError error)
+{
+    if (replies.isEmpty()) {
+        return;
+    }
+    updateTrackedWrites();
+    foreach (ZWaveReply *reply, replies) {
+        finishReply(reply, error);
+    }
+}
+
+void OpenZWaveBackend::updateTrackedWrites()
+{
+    int count = 0;
+    foreach (OpenZWaveNetwork *network, m_networks) {
+        count += network->writeTracker.count();
+    }
+    m_trackedWrites.store(count, std::memory_order_relaxed);
+}
+
+bool OpenZWaveBackend::writeValue(OpenZWaveNetwork *network, const ZWaveValue &value)
+{
+    // Poll the value at full rate again to pick up the device's reaction
+    setPollIntensity(network, value.id(), network->pollingEngine.valueWritten(value.id()));
+
+    OpenZWave::ValueID valueId(network->homeId, value.id());
+    bool status = sendValue(valueId, value);
+    recordEvent(OpenZWaveEventRing::EventWrite, network->homeId, valueId.GetNodeId(), value.id(), status);
+    return status;
+}
+
+bool OpenZWaveBackend::sendValue(const OpenZWave::ValueID &valueId, const ZWaveValue &value)
+{
     try {
         switch (value.type()) {
         case ZWaveValue::TypeBool:
@@ -415,13 +857,138 @@ bool OpenZWaveBackend::setValue(const QUuid &networkUuid, quint8 nodeId, const Z
     }
 }
 
-ZWaveValue OpenZWaveBackend::readValue(quint32 homeId, quint8 nodeId, quint64 id, ZWaveValue::Genre genre, ZWaveValue::CommandClass commandClassId, quint8 instance, quint16 index, ZWaveValue::Type type)
+bool OpenZWaveBackend::isNodeSleeping(OpenZWaveNetwork *network, quint8 nodeId)
+{
+    try {
+        if (m_manager->IsNodeListeningDevice(network->homeId, nodeId) || m_manager->IsNodeFrequentListeningDevice(network->homeId, nodeId)) {
+            return false;
+        }
+        return !m_manager->IsNodeAwake(network->homeId, nodeId);
+    } catch (const OpenZWave::OZWException &e) {
+        qCWarning(dcOpenZWave()) << "Error fetching sleep state of node" << nodeId << e.what();
+        return false;
+    }
+}
+
+void OpenZWaveBackend::flushPendingWrites(OpenZWaveNetwork *network, quint8 nodeId)
+{
+    QList<ZWaveValue> writes = network->wakeUpQueue.take(nodeId);
+    if (writes.isEmpty()) {
+        return;
+    }
+    qCDebug(dcOpenZWave()) << "Sending" << writes.count() << "pending writes to node" << nodeId << "in network" << network->homeId;
+    // The node only stays awake for a few seconds, don't let polls get in between
+    m_trafficScheduler.schedule(OpenZWaveTrafficScheduler::PriorityInteractive, [this, network, nodeId, &writes](){
+        foreach (const ZWaveValue &value, writes) {
+            if (!writeValue(network, value)) {
+                qCWarning(dcOpenZWave()) << "Pending write of value" << value.id() << "to node" << nodeId << "failed";
+                finishPendingWrites(network->writeTracker.takeValue(value.id(), m_clock.elapsed(), false), ZWave::ZWaveErrorBackendError);
+                continue;
+            }
+            network->writeTracker.sent(value.id(), m_manager->GetSendQueueCount(network->homeId));
+        }
+    });
+}
+
+const OpenZWaveNodeInfo *OpenZWaveBackend::nodeInfo(const QUuid &networkUuid, quint8 nodeId)
+{
+    OpenZWaveNetwork *network = m_networks.value(networkUuid);
+    if (!network) {
+        return nullptr;
+    }
+    OpenZWaveNodeInfo *info = network->nodeInfo(nodeId);
+    if (info && !info->valid) {
+        // Until the driver is ready only what came from the snapshot is known
+        if (network->homeId == 0) {
+            return nullptr;
+        }
+        // Not filled or invalidated since, fetch what OpenZWave knows right now
+        fillNodeInfo(network, nodeId);
+    }
+    return info;
+}
+
+void OpenZWaveBackend::fillNodeInfo(OpenZWaveNetwork *network, quint8 nodeId)
+{
+    OpenZWaveNodeInfo *info = network->nodeInfo(nodeId);
+    if (!info) {
+        qCWarning(dcOpenZWave()) << "Node id" << nodeId << "out of range";
+        return;
+    }
+    quint32 homeId = network->homeId;
+
+    info->name = QString::fromStdString(m_manager->GetNodeName(homeId, nodeId));
+    info->manufacturerName = QString::fromStdString(m_manager->GetNodeManufacturerName(homeId, nodeId));
+    info->productName = QString::fromStdString(m_manager->GetNodeProductName(homeId, nodeId));
+    // OpenZWave reports the ids as "0x1234" strings, strtoul() takes care of the prefix
+    info->manufacturerId = strtoul(m_manager->GetNodeManufacturerId(homeId, nodeId).c_str(), nullptr, 16);
+    info->productId = strtoul(m_manager->GetNodeProductId(homeId, nodeId).c_str(), nullptr, 16);
+    info->productType = strtoul(m_manager->GetNodeProductType(homeId, nodeId).c_str(), nullptr, 16);
+    info->basic = m_manager->GetNodeBasic(homeId, nodeId);
+    info->deviceType = m_manager->GetNodeDeviceType(homeId, nodeId);
+    info->role = m_manager->GetNodeRole(homeId, nodeId);
+    info->security = m_manager->GetNodeSecurity(homeId, nodeId);
+    info->version = m_manager->GetNodeVersion(homeId, nodeId);
+    info->plusType = m_manager->GetNodePlusType(homeId, nodeId);
+    info->zwavePlus = m_manager->IsNodeZWavePlus(homeId, nodeId);
+    info->beaming = m_manager->IsNodeBeamingDevice(homeId, nodeId);
+
+    bool secured;
+    OpenZWave::ValueID valueId(homeId, nodeId, OpenZWave::ValueID::ValueGenre_System, 0x98, 0, 0, OpenZWave::ValueID::ValueType_Bool);
+    try {
+        m_manager->GetValueAsBool(valueId, &secured);
+    } catch (const OpenZWave::OZWException &e) {
+        secured = false;
+    }
+    info->secure = secured;
+
+    info->valid = true;
+}
+
+ZWaveValue OpenZWaveBackend::readValue(OpenZWaveNetwork *network, quint8 nodeId, quint64 id, ZWaveValue::Genre genre, ZWaveValue::CommandClass commandClassId, quint8 instance, quint16 index, ZWaveValue::Type type)
+{
+    OpenZWave::ValueID valueId(network->homeId, nodeId, (OpenZWave::ValueID::ValueGenre)genre, commandClassId, instance, index, (OpenZWave::ValueID::ValueType)type);
+    OpenZWaveValueMetadata &metadata = readValueMetadata(network, valueId);
+
+    ZWaveValue value(id, genre, commandClassId, instance, index, type, metadata.help);
+    readValueData(valueId, metadata, value);
+    return value;
+}
+
+OpenZWaveValueMetadata &OpenZWaveBackend::readValueMetadata(OpenZWaveNetwork *network, const OpenZWave::ValueID &valueId)
+{
+    OpenZWaveValueMetadata metadata;
+    metadata.help = m_stringPool.intern(m_manager->GetValueHelp(valueId));
+    metadata.units = m_stringPool.intern(m_manager->GetValueUnits(valueId));
+    metadata.min = m_manager->GetValueMin(valueId);
+    metadata.max = m_manager->GetValueMax(valueId);
+    if (valueId.GetType() == OpenZWave::ValueID::ValueType_List) {
+        readValueListItems(valueId, metadata);
+    }
+    return network->metadata.insert(valueId.GetId(), metadata).value();
+}
+
+void OpenZWaveBackend::readValueListItems(const OpenZWave::ValueID &valueId, OpenZWaveValueMetadata &metadata)
+{
+    std::vector<std::string> items;
+    m_manager->GetValueListItems(valueId, &items);
+    metadata.listItems = m_stringPool.intern(items);
+
+    std::vector<qint32> values;
+    m_manager->GetValueListValues(valueId, &values);
+    metadata.listValues.clear();
+    metadata.listValues.reserve(static_cast<int>(values.size()));
+    for (qint32 value: values) {
+        metadata.listValues.append(value);
+    }
+}
+
+void OpenZWaveBackend::readValueData(const OpenZWave::ValueID &valueId, OpenZWaveValueMetadata &metadata, ZWaveValue &value)
 {
-    OpenZWave::ValueID valueId(homeId, nodeId, (OpenZWave::ValueID::ValueGenre)genre, commandClassId, instance, index, (OpenZWave::ValueID::ValueType)type);
     QVariant variant;
     int selection = -1;
 
-    switch (type) {
+    switch (value.type()) {
     case ZWaveValue::TypeButton:
     case ZWaveValue::TypeBool: {
         bool val;
@@ -448,16 +1015,16 @@ ZWaveValue OpenZWaveBackend::readValue(quint32 homeId, quint8 nodeId, quint64 id
         break;
     }
     case ZWaveValue::TypeList: {
-        std::vector<std::string> val;
-        m_manager->GetValueListItems(valueId, &val);
-        QStringList ret;
-        for (const std::string &str: val) {
-            ret.append(QString::fromStdString(str));
-        }
-        variant = ret;
-        std::string selectionStr;
-        m_manager->GetValueListSelection(valueId, &selectionStr);
-        selection = ret.indexOf(QString::fromStdString(selectionStr));
+        // Only the selection changes, the shared item table is handed out as is
+        qint32 selected = 0;
+        m_manager->GetValueListSelection(valueId, &selected);
+        selection = metadata.listValues.indexOf(selected);
+        if (selection < 0) {
+            // The items changed since they have been read
+            readValueListItems(valueId, metadata);
+            selection = metadata.listValues.indexOf(selected);
+        }
+        variant = metadata.listItems;
         break;
     }
     case ZWaveValue::TypeDecimal: {
@@ -479,183 +1046,367 @@ ZWaveValue OpenZWaveBackend::readValue(quint32 homeId, quint8 nodeId, quint64 id
 //        m_manager->GetValueAsBitSet(valueId, )
 //        break;
     default:
-        qCCritical(dcOpenZWave()) << "Unhandled type in readValue" << type;
+        qCCritical(dcOpenZWave()) << "Unhandled type in readValue" << value.type();
     }
 
-    QString description = QString::fromStdString(m_manager->GetValueHelp(valueId));
-
-    ZWaveValue value(id, genre, commandClassId, instance, index, type, description);
     value.setValue(variant, selection);
-    return value;
 }
 
-void OpenZWaveBackend::updateNodeLinkQuality(quint32 homeId, quint8 nodeId)
+void OpenZWaveBackend::updateNodeLinkQuality(OpenZWaveNetwork *network, quint8 nodeId)
 {
+    qint64 now = m_clock.elapsed();
+    if (!network->linkQualitySampler.isDue(nodeId, now)) {
+        return;
+    }
+
     OpenZWave::Node::NodeData nodeData;
-    m_manager->GetNodeStatistics(homeId, nodeId, &nodeData);
-//    qCDebug(dcOpenZWave()) << "Driver stats:" << nodeData.m_quality;
+    m_manager->GetNodeStatistics(network->homeId, nodeId, &nodeData);
+    quint8 linkQuality = OpenZWaveLinkQualitySampler::linkQuality(nodeData);
 
-#ifdef OZW_16
-//    qCDebug(dcOpenZWave()) << "RSSI values:" << nodeData.m_rssi_1 << QByteArray::fromHex(QByteArray(nodeData.m_rssi_1, 8));
-
-    QStringList rssis = {
-        QString(nodeData.m_rssi_1),
-        QString(nodeData.m_rssi_2),
-        QString(nodeData.m_rssi_3),
-        QString(nodeData.m_rssi_4),
-        QString(nodeData.m_rssi_5),
-    };
-
-    quint8 avg = 0;
-    quint8 count = 0;
-    foreach (const QString &rssi, rssis) {
-        if (rssi == "MAX") {
-            avg += -50;
-            count++;
-        } else if (rssi == "MIN") {
-            avg += -100;
-            count++;
-        } else {
-            bool ok;
-            quint8 val = rssi.toInt(&ok);
-            if (ok) {
-                avg += val;
-                count++;
+    if (network->linkQualitySampler.update(nodeId, now, linkQuality)) {
+        emit nodeLinkQualityStatus(network->networkUuid, nodeId, linkQuality);
+    }
+}
+
+void OpenZWaveBackend::collectNodeStatistics()
+{
+    qint64 now = m_clock.elapsed();
+    bool started = false;
+    foreach (OpenZWaveNetwork *network, m_networks) {
+        if (network->homeId == 0) {
+            continue;
+        }
+        started = true;
+        foreach (quint8 nodeId, network->nodeIds) {
+            OpenZWave::Node::NodeData nodeData;
+            m_manager->GetNodeStatistics(network->homeId, nodeId, &nodeData);
+            OpenZWaveNodeStatistics::Sample sample = OpenZWaveNodeStatistics::sample(nodeData, now);
+            network->nodeStatistics.add(nodeId, sample);
+
+            // Also serves as link quality update for nodes which are quiet otherwise
+            if (network->linkQualitySampler.update(nodeId, now, sample.linkQuality)) {
+                emit nodeLinkQualityStatus(network->networkUuid, nodeId, sample.linkQuality);
             }
         }
     }
-    if (count > 0) {
-        avg /= count;
-    } else {
-        avg = -76;
+    // Nothing new to write, don't wear the flash for it
+    if (started) {
+        writeNodeStatistics();
     }
-
-    quint8 linkQuality = qMin(100, qMax(0, 2 * (avg + 100)));
-#else
-    quint8 linkQuality = qMin(100, qMax(0, 2 * (nodeData.m_quality + 100)));
-#endif
-
-    emit nodeLinkQualityStatus(m_homeIds.key(homeId), nodeId, linkQuality);
 }
 
-void OpenZWaveBackend::ozwCallback(const OpenZWave::Notification *notification, void *context)
+void OpenZWaveBackend::writeNodeStatistics()
 {
-    Q_UNUSED(context)
-    OpenZWaveBackend *self = static_cast<OpenZWaveBackend*>(context);
-
-    switch (notification->GetType()) {
-    case OpenZWave::Notification::Type_ValueAdded: {
-        OpenZWave::ValueID valueId = notification->GetValueID();
-        QMetaObject::invokeMethod(self, "onValueAdded",
-                                  Q_ARG(quint32, notification->GetHomeId()),
-                                  Q_ARG(quint8, notification->GetNodeId()),
-                                  Q_ARG(quint64, valueId.GetId()),
-                                  Q_ARG(ZWaveValue::Genre, static_cast<ZWaveValue::Genre>(valueId.GetGenre())),
-                                  Q_ARG(ZWaveValue::CommandClass, static_cast<ZWaveValue::CommandClass>(valueId.GetCommandClassId())),
-                                  Q_ARG(quint8, valueId.GetInstance()),
-                                  Q_ARG(quint16, valueId.GetIndex()),
-                                  Q_ARG(ZWaveValue::Type, static_cast<ZWaveValue::Type>(valueId.GetType()))
-                                  );
-        break;
+    QSaveFile file(m_storagePath + "nodestatistics.txt");
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        qCWarning(dcOpenZWave()) << "Cannot write node statistics:" << file.errorString();
+        return;
     }
-    case OpenZWave::Notification::Type_ValueChanged: {
-        OpenZWave::ValueID valueId = notification->GetValueID();
-        QMetaObject::invokeMethod(self, "onValueChanged",
-                                  Q_ARG(quint32, notification->GetHomeId()),
-                                  Q_ARG(quint8, notification->GetNodeId()),
-                                  Q_ARG(quint64, valueId.GetId()),
-                                  Q_ARG(ZWaveValue::Genre, static_cast<ZWaveValue::Genre>(valueId.GetGenre())),
-                                  Q_ARG(ZWaveValue::CommandClass, static_cast<ZWaveValue::CommandClass>(valueId.GetCommandClassId())),
-                                  Q_ARG(quint8, valueId.GetInstance()),
-                                  Q_ARG(quint16, valueId.GetIndex()),
-                                  Q_ARG(ZWaveValue::Type, static_cast<ZWaveValue::Type>(valueId.GetType()))
-                                  );
-
-        break;
+    QTextStream stream(&file);
+    foreach (OpenZWaveNetwork *network, m_networks) {
+        QString homeId = QString::number(network->homeId, 16);
+        foreach (quint8 nodeId, network->nodeStatistics.nodes()) {
+            OpenZWaveNodeStatistics::Sample sample = network->nodeStatistics.latest(nodeId);
+            QString labels = QString("{home_id=\"0x%1\",node=\"%2\"}").arg(homeId).arg(nodeId);
+            stream << "openzwave_node_sent_total" << labels << " " << sample.sent << "\n";
+            stream << "openzwave_node_sent_failed_total" << labels << " " << sample.sentFailed << "\n";
+            stream << "openzwave_node_retries_total" << labels << " " << sample.retries << "\n";
+            stream << "openzwave_node_received_total" << labels << " " << sample.received << "\n";
+            stream << "openzwave_node_received_duplicates_total" << labels << " " << sample.receivedDuplicates << "\n";
+            stream << "openzwave_node_received_unsolicited_total" << labels << " " << sample.receivedUnsolicited << "\n";
+            stream << "openzwave_node_last_request_rtt_ms" << labels << " " << sample.lastRequestRtt << "\n";
+            stream << "openzwave_node_average_request_rtt_ms" << labels << " " << sample.averageRequestRtt << "\n";
+            stream << "openzwave_node_last_response_rtt_ms" << labels << " " << sample.lastResponseRtt << "\n";
+            stream << "openzwave_node_average_response_rtt_ms" << labels << " " << sample.averageResponseRtt << "\n";
+            stream << "openzwave_node_link_quality" << labels << " " << static_cast<int>(sample.linkQuality) << "\n";
+            stream << "openzwave_node_hops" << labels << " " << static_cast<int>(sample.hops) << "\n";
+            stream << "openzwave_node_tx_time_ms" << labels << " " << sample.txTime << "\n";
+        }
     }
-    case OpenZWave::Notification::Type_ValueRefreshed: {
-        // TODO: executeAction could use this as reply..
-        OpenZWave::ValueID valueId = notification->GetValueID();
-        QMetaObject::invokeMethod(self, "onValueChanged",
-                                  Q_ARG(quint32, notification->GetHomeId()),
-                                  Q_ARG(quint8, notification->GetNodeId()),
-                                  Q_ARG(quint64, valueId.GetId()),
-                                  Q_ARG(ZWaveValue::Genre, static_cast<ZWaveValue::Genre>(valueId.GetGenre())),
-                                  Q_ARG(ZWaveValue::CommandClass, static_cast<ZWaveValue::CommandClass>(valueId.GetCommandClassId())),
-                                  Q_ARG(quint8, valueId.GetInstance()),
-                                  Q_ARG(quint16, valueId.GetIndex()),
-                                  Q_ARG(ZWaveValue::Type, static_cast<ZWaveValue::Type>(valueId.GetType()))
-                                  );
-
-        break;
+    stream.flush();
+    if (!file.commit()) {
+        qCWarning(dcOpenZWave()) << "Cannot write node statistics:" << file.errorString();
     }
+}
+
+void OpenZWaveBackend::sampleDriverStatistics()
+{
+    qint64 now = m_clock.elapsed();
+    foreach (OpenZWaveNetwork *network, m_networks) {
+        if (network->homeId == 0) {
+            continue;
+        }
+        OpenZWave::Driver::DriverData driverData;
+        m_manager->GetDriverStatistics(network->homeId, &driverData);
+        if (!network->driverMonitor.update(OpenZWaveDriverMonitor::fromDriverData(driverData), now)) {
+            continue;
+        }
+        OpenZWaveDriverMonitor::Rates rates = network->driverMonitor.rates();
+        if (network->driverMonitor.isDegraded()) {
+            qCWarning(dcOpenZWave()) << "Serial link of network" << network->homeId << "degraded:"
+                                     << rates.writes << "writes in" << rates.interval << "ms,"
+                                     << "retries" << rates.retryRatio << "drops" << rates.dropRatio
+                                     << "timeouts" << rates.timeoutRatio << "frame errors/min" << rates.frameErrorsPerMinute;
+        } else {
+            qCInfo(dcOpenZWave()) << "Serial link of network" << network->homeId << "recovered";
+        }
+        recordEvent(OpenZWaveEventRing::EventDriverDegraded, network->homeId, 0, 0, network->driverMonitor.isDegraded());
+        if (network->driverMonitor.isDegraded()) {
+            dumpEventTraceOnFault();
+        }
+        emit driverDegradedChanged(network->networkUuid, network->driverMonitor.isDegraded());
+    }
+}
+
+void OpenZWaveBackend::setHealQuietHours(const QTime &start, const QTime &end)
+{
+    m_healQuietStart = start;
+    m_healQuietEnd = end;
+}
+
+OpenZWaveHealScheduler::Result OpenZWaveBackend::healResult(const QUuid &networkUuid, quint8 nodeId) const
+{
+    OpenZWaveNetwork *network = m_networks.value(networkUuid);
+    if (!network) {
+        return OpenZWaveHealScheduler::Result();
+    }
+    return network->healScheduler.result(nodeId);
+}
+
+bool OpenZWaveBackend::isHealQuietTime() const
+{
+    if (!m_healQuietStart.isValid() || !m_healQuietEnd.isValid()) {
+        return false;
+    }
+    QTime now = QTime::currentTime();
+    if (m_healQuietStart <= m_healQuietEnd) {
+        return now >= m_healQuietStart && now < m_healQuietEnd;
+    }
+    // Quiet hours across midnight
+    return now >= m_healQuietStart || now < m_healQuietEnd;
+}
+
+void OpenZWaveBackend::scheduleHeals()
+{
+    qint64 now = m_clock.elapsed();
+    bool quietTime = isHealQuietTime();
+    foreach (OpenZWaveNetwork *network, m_networks) {
+        if (network->homeId == 0) {
+            continue;
+        }
+        OpenZWaveHealScheduler &healScheduler = network->healScheduler;
+
+        quint8 current = healScheduler.currentNode();
+        if (current != 0 && now - healScheduler.result(current).started >= OpenZWaveHealScheduler::Timeout) {
+            qCDebug(dcOpenZWave()) << "No completion reported for healing node" << current << "in network" << network->homeId;
+            finishHeal(network, false);
+        }
+
+        foreach (quint8 nodeId, healScheduler.pendingMeasurements(now)) {
+            OpenZWave::Node::NodeData nodeData;
+            m_manager->GetNodeStatistics(network->homeId, nodeId, &nodeData);
+            OpenZWaveHealScheduler::Result result = healScheduler.result(nodeId);
+            // Wait for requests over the new routes, the average would still be the old one
+            if (nodeData.m_sentCnt <= result.sentAtFinish) {
+                continue;
+            }
+            healScheduler.measure(nodeId, nodeData.m_averageRequestRTT);
+            qCInfo(dcOpenZWave()) << "Average request RTT of node" << nodeId << "in network" << network->homeId
+                                  << "went from" << result.rttBefore << "ms to" << nodeData.m_averageRequestRTT << "ms after healing";
+        }
+
+        if (!quietTime || healScheduler.isBusy()
+                || (healScheduler.lastStarted() >= 0 && now - healScheduler.lastStarted() < HealStagger)) {
+            continue;
+        }
+        // The controller doesn't need healing and sleeping nodes can't be reached
+        quint8 controllerNodeId = m_manager->GetControllerNodeId(network->homeId);
+        QList<quint8> candidates;
+        foreach (quint8 nodeId, network->nodeIds) {
+            if (nodeId != controllerNodeId && !isNodeSleeping(network, nodeId)) {
+                candidates.append(nodeId);
+            }
+        }
+        quint8 nodeId = healScheduler.nextNode(candidates, now);
+        if (nodeId == 0) {
+            continue;
+        }
+
+        // Maintenance traffic may wait for a while, the heal only counts as started once it is sent
+        healScheduler.queue(nodeId);
+        QUuid networkUuid = network->networkUuid;
+        m_trafficScheduler.schedule(OpenZWaveTrafficScheduler::PriorityMaintenance, [this, networkUuid, nodeId](){
+            OpenZWaveNetwork *network = m_networks.value(networkUuid);
+            if (!network) {
+                return;
+            }
+            if (network->homeId == 0) {
+                network->healScheduler.cancel();
+                return;
+            }
+            OpenZWave::Node::NodeData nodeData;
+            m_manager->GetNodeStatistics(network->homeId, nodeId, &nodeData);
+            network->healScheduler.start(nodeId, m_clock.elapsed(), nodeData.m_averageRequestRTT);
+            qCInfo(dcOpenZWave()) << "Healing node" << nodeId << "in network" << network->homeId << "with an average request RTT of" << nodeData.m_averageRequestRTT << "ms";
+            m_manager->HealNetworkNode(network->homeId, nodeId, true);
+        });
+    }
+}
+
+void OpenZWaveBackend::finishHeal(OpenZWaveNetwork *network, bool success)
+{
+    quint8 nodeId = network->healScheduler.currentNode();
+    if (nodeId == 0) {
+        return;
+    }
+    // Requests up to here may still have gone over the old routes
+    OpenZWave::Node::NodeData nodeData;
+    m_manager->GetNodeStatistics(network->homeId, nodeId, &nodeData);
+    network->healScheduler.finish(m_clock.elapsed(), success, nodeData.m_sentCnt);
+    qCDebug(dcOpenZWave()) << "Healing node" << nodeId << "in network" << network->homeId << (success ? "completed" : "failed");
+}
+
+void OpenZWaveBackend::recordEvent(OpenZWaveEventRing::EventType type, quint32 homeId, quint8 nodeId, quint64 valueId, quint8 arg1, quint8 arg2)
+{
+    m_eventRing.record(m_clock.nsecsElapsed() / 1000, type, homeId, nodeId, valueId, arg1, arg2);
+}
+
+bool OpenZWaveBackend::dumpEventTrace(const QString &fileName) const
+{
+    return m_eventRing.dump(fileName);
+}
+
+void OpenZWaveBackend::dumpEventTraceOnFault()
+{
+    qint64 now = m_clock.elapsed();
+    if (m_lastFaultDump >= 0 && now - m_lastFaultDump < FaultDumpInterval) {
+        return;
+    }
+    m_lastFaultDump = now;
+    QString fileName = m_storagePath + "eventtrace-fault.bin";
+    if (m_eventRing.dump(fileName)) {
+        qCWarning(dcOpenZWave()) << "Dumped the last" << qMin<quint64>(m_eventRing.count(), OpenZWaveEventRing::Capacity) << "backend events to" << fileName;
+    } else {
+        qCWarning(dcOpenZWave()) << "Cannot dump backend events to" << fileName;
+    }
+}
+
+OpenZWaveDriverMonitor::Rates OpenZWaveBackend::driverRates(const QUuid &networkUuid) const
+{
+    OpenZWaveNetwork *network = m_networks.value(networkUuid);
+    if (!network) {
+        return OpenZWaveDriverMonitor::Rates();
+    }
+    return network->driverMonitor.rates();
+}
+
+OpenZWaveDriverMonitor::Counters OpenZWaveBackend::driverCounters(const QUuid &networkUuid) const
+{
+    OpenZWaveNetwork *network = m_networks.value(networkUuid);
+    if (!network) {
+        return OpenZWaveDriverMonitor::Counters();
+    }
+    return network->driverMonitor.counters();
+}
+
+void OpenZWaveBackend::setDriverThresholds(const QUuid &networkUuid, const OpenZWaveDriverMonitor::Thresholds &thresholds)
+{
+    OpenZWaveNetwork *network = m_networks.value(networkUuid);
+    if (network) {
+        network->driverMonitor.setThresholds(thresholds);
+    }
+}
+
+OpenZWaveNodeStatistics::Sample OpenZWaveBackend::nodeStatistics(const QUuid &networkUuid, quint8 nodeId) const
+{
+    OpenZWaveNetwork *network = m_networks.value(networkUuid);
+    if (!network) {
+        return OpenZWaveNodeStatistics::Sample();
+    }
+    return network->nodeStatistics.latest(nodeId);
+}
+
+QList<OpenZWaveNodeStatistics::Sample> OpenZWaveBackend::nodeStatisticsHistory(const QUuid &networkUuid, quint8 nodeId) const
+{
+    OpenZWaveNetwork *network = m_networks.value(networkUuid);
+    if (!network) {
+        return QList<OpenZWaveNodeStatistics::Sample>();
+    }
+    return network->nodeStatistics.history(nodeId);
+}
+
+void OpenZWaveBackend::setNodeStatisticsInterval(int msecs)
+{
+    if (msecs > 0) {
+        m_nodeStatisticsTimer.start(msecs);
+    } else {
+        m_nodeStatisticsTimer.stop();
+    }
+}
+
+void OpenZWaveBackend::ozwCallback(const OpenZWave::Notification *notification, void *context)
+{
+    OpenZWaveBackend *self = static_cast<OpenZWaveBackend*>(context);
+
+    OpenZWaveNotificationRecord record;
+    record.type = notification->GetType();
+    record.homeId = notification->GetHomeId();
+    record.nodeId = notification->GetNodeId();
+
+    switch (notification->GetType()) {
+    case OpenZWave::Notification::Type_ValueAdded:
+    case OpenZWave::Notification::Type_ValueChanged:
+    case OpenZWave::Notification::Type_ValueRefreshed:
     case OpenZWave::Notification::Type_ValueRemoved:
-        QMetaObject::invokeMethod(self, "onValueRemoved", Q_ARG(quint32, notification->GetHomeId()), Q_ARG(quint8, notification->GetNodeId()), Q_ARG(quint64, notification->GetValueID().GetId()));
+        record.valueId = notification->GetValueID().GetId();
         break;
     case OpenZWave::Notification::Type_Group:
-        qCDebug(dcOpenZWave) << "Group information changed for home Id" << notification->GetHomeId();
-        break;
-    case OpenZWave::Notification::Type_NodeNaming:
-        QMetaObject::invokeMethod(self, "onNodeNaming", Q_ARG(quint32, notification->GetHomeId()), Q_ARG(quint8, notification->GetNodeId()));
-        break;
-    case OpenZWave::Notification::Type_DriverReady:
-        QMetaObject::invokeMethod(self, "onDriverReady", Q_ARG(quint32, notification->GetHomeId()));
         break;
     case OpenZWave::Notification::Type_DriverFailed:
 #ifdef OZW_16
-        QMetaObject::invokeMethod(self, "onDriverFailed", Q_ARG(QString, QString::fromStdString(notification->GetComPort())));
-#else
-        QMetaObject::invokeMethod(self, "onDriverFailed");
+        // The serial port doesn't fit into the record. It's parked aside and the record refers to it, so the
+        // failure is still handled in order with the notifications of the other drivers.
+        record.valueId = self->parkFailedSerialPort(QString::fromStdString(notification->GetComPort()));
 #endif
         break;
+    case OpenZWave::Notification::Type_NodeNaming:
+    case OpenZWave::Notification::Type_DriverReady:
     case OpenZWave::Notification::Type_NodeNew:
-        QMetaObject::invokeMethod(self, "onNewNode", Q_ARG(quint32, notification->GetHomeId()), Q_ARG(quint8, notification->GetNodeId()));
-        break;
     case OpenZWave::Notification::Type_NodeAdded:
-        QMetaObject::invokeMethod(self, "onNodeAdded", Q_ARG(quint32, notification->GetHomeId()), Q_ARG(quint8, notification->GetNodeId()));
-        break;
     case OpenZWave::Notification::Type_NodeRemoved:
-        QMetaObject::invokeMethod(self, "onNodeRemoved", Q_ARG(quint32, notification->GetHomeId()), Q_ARG(quint8, notification->GetNodeId()));
-        break;
     case OpenZWave::Notification::Type_NodeProtocolInfo:
-        QMetaObject::invokeMethod(self, "onNodeProtocolInfoReceived", Q_ARG(quint32, notification->GetHomeId()), Q_ARG(quint8, notification->GetNodeId()));
-        break;
-    case OpenZWave::Notification::Type_NodeEvent:
-        qCWarning(dcOpenZWave()) << "Node event:" << notification->GetEvent() << QString::fromStdString(notification->GetAsString());
-        break;
-    case OpenZWave::Notification::Type_Notification:
-        QMetaObject::invokeMethod(self, "onZWaveNotification", Q_ARG(quint32, notification->GetHomeId()), Q_ARG(quint8, notification->GetNodeId()), Q_ARG(OpenZWaveBackend::NotificationCode, static_cast<NotificationCode>(notification->GetNotification())));
-        break;
     case OpenZWave::Notification::Type_EssentialNodeQueriesComplete:
-        QMetaObject::invokeMethod(self, "onEssentialNodeQueriesComplete", Q_ARG(quint32, notification->GetHomeId()));
-        break;
     case OpenZWave::Notification::Type_NodeQueriesComplete:
-        QMetaObject::invokeMethod(self, "onNodeQueryComplete", Q_ARG(quint32, notification->GetHomeId()), Q_ARG(quint8, notification->GetNodeId()));
-        break;
     case OpenZWave::Notification::Type_AwakeNodesQueried:
-        QMetaObject::invokeMethod(self, "onAwakeNodesQueried", Q_ARG(quint32, notification->GetHomeId()));
-        break;
     case OpenZWave::Notification::Type_AllNodesQueriedSomeDead:
-        QMetaObject::invokeMethod(self, "onAllNodesQueried", Q_ARG(quint32, notification->GetHomeId()));
-        break;
     case OpenZWave::Notification::Type_AllNodesQueried:
-        QMetaObject::invokeMethod(self, "onAllNodesQueried", Q_ARG(quint32, notification->GetHomeId()));
-        break;
     case OpenZWave::Notification::Type_DriverRemoved:
-        QMetaObject::invokeMethod(self, "onDriverRemoved", Q_ARG(quint32, notification->GetHomeId()));
+        break;
+    case OpenZWave::Notification::Type_NodeEvent:
+        record.code = notification->GetEvent();
+        break;
+    case OpenZWave::Notification::Type_Notification:
+        record.code = notification->GetNotification();
+        // MsgComplete comes for every message sent, polls included, but only matters while asynchronous
+        // writes wait for confirmation. Don't let them cost a queue slot and a dispatch otherwise.
+        if (record.code == NotificationCodeMsgComplete && self->m_trackedWrites.load(std::memory_order_relaxed) == 0) {
+            return;
+        }
         break;
     case OpenZWave::Notification::Type_ControllerCommand:
         // OZW docs seem broken... They claim that GetEvent -> ControllerCommand, and GetNotification -> ControllerState
         // However, at least in 1.6, GetEvent seems to return the ControllerState while there is a GetCommand to retrieve the command
 #ifdef OZW_16
-        QMetaObject::invokeMethod(self, "onControllerCommand", Q_ARG(quint32, notification->GetHomeId()), Q_ARG(OpenZWaveBackend::ControllerCommand, static_cast<ControllerCommand>(notification->GetCommand())), Q_ARG(OpenZWaveBackend::ControllerState, static_cast<ControllerState>(notification->GetEvent())));
+        record.command = notification->GetCommand();
+        record.code = notification->GetEvent();
 #else
         // Prior to 1.6, there's no GetCommand, let's hope it actually does what the docs say...
         qCDebug(dcOpenZWave()) << "Controller command callback received: \n"
 //                               << "Command:" << static_cast<OpenZWaveBackend::ControllerCommand>(notification->GetCommand()) << notification->GetCommand() << "\n"
                                << "Event:" << static_cast<OpenZWaveBackend::ControllerState>(notification->GetEvent()) << notification->GetEvent() << "\n"
                                << "Notification:" << notification->GetNotification();
-        QMetaObject::invokeMethod(self, "onControllerCommand", Q_ARG(quint32, notification->GetHomeId()), Q_ARG(OpenZWaveBackend::ControllerCommand, static_cast<ControllerCommand>(notification->GetEvent())), Q_ARG(OpenZWaveBackend::ControllerState, static_cast<ControllerState>(notification->GetEvent())));
+        record.command = notification->GetEvent();
+        record.code = notification->GetEvent();
 #endif
         break;
 //    case OpenZWave::Notification::Type_ManufacturerSpecificDBReady:
@@ -663,15 +1414,280 @@ void OpenZWaveBackend::ozwCallback(const OpenZWave::Notification *notification,
 //        break;
 #ifdef OZW_16
     case OpenZWave::Notification::Type_UserAlerts:
-        qCWarning(dcOpenZWave()) << "OpenZWave user alert:" << static_cast<UserAlertNotification>(notification->GetUserAlertType()) << QString::fromStdString(notification->GetAsString());
+        record.code = notification->GetUserAlertType();
         break;
 #endif
     default:
         qCWarning(dcOpenZWave()) << "Unhandled notification" << notification->GetType();
+        return;
+    }
 
+    self->enqueueNotification(record);
+}
+
+void OpenZWaveBackend::enqueueNotification(OpenZWaveNotificationRecord record)
+{
+    record.timestamp = m_clock.nsecsElapsed() / 1000;
+    // Only the first record after a drain needs to post an event, everything else is picked up by the same drain
+    if (m_notificationQueue.enqueue(record)) {
+        QMetaObject::invokeMethod(this, [this](){ drainNotifications(); }, Qt::QueuedConnection);
     }
 }
 
+void OpenZWaveBackend::drainNotifications()
+{
+    int batchSize = m_notificationQueue.drain([this](const OpenZWaveNotificationRecord &record) {
+        if (m_trace.isOpen()) {
+            m_trace.write(record);
+        }
+        quint64 dispatched = m_clock.nsecsElapsed() / 1000;
+        m_eventRing.record(dispatched, OpenZWaveEventRing::EventNotification, record.homeId, record.nodeId, record.valueId, record.type, record.code);
+        processNotification(record);
+        quint64 handled = m_clock.nsecsElapsed() / 1000;
+
+        // Looked up after handling, the network of a DriverReady is only known by then
+        OpenZWaveNetwork *network = m_networksByHomeId.value(record.homeId);
+        OpenZWaveDispatchStatistics &statistics = network ? network->dispatchStatistics : m_dispatchStatistics;
+        statistics.record(record.type, record.code, record.type == OpenZWave::Notification::Type_Notification, dispatched - record.timestamp, handled - dispatched);
+    });
+    if (batchSize >= static_cast<int>(OpenZWaveNotificationQueue::Capacity)) {
+        OpenZWaveNotificationQueue::Statistics statistics = m_notificationQueue.statistics();
+        qCDebug(dcOpenZWave()) << "Drained" << batchSize << "notifications. Overflows so far:" << statistics.overflows;
+    }
+}
+
+// Notification types are small consecutive numbers, so a flat table of typed handlers indexed by the type
+// replaces both the invokeMethod() name lookup and the per notification switch.
+class OpenZWaveBackend::NotificationDispatchTable
+{
+public:
+    static const int Size = 32;
+
+    NotificationDispatchTable() {
+        for (int i = 0; i < Size; i++) {
+            handlers[i] = nullptr;
+        }
+        handlers[OpenZWave::Notification::Type_ValueAdded] = &OpenZWaveBackend::dispatchValueAdded;
+        handlers[OpenZWave::Notification::Type_ValueChanged] = &OpenZWaveBackend::dispatchValueChanged;
+        handlers[OpenZWave::Notification::Type_ValueRefreshed] = &OpenZWaveBackend::dispatchValueRefreshed;
+        handlers[OpenZWave::Notification::Type_ValueRemoved] = &OpenZWaveBackend::dispatchValueRemoved;
+        handlers[OpenZWave::Notification::Type_NodeNaming] = &OpenZWaveBackend::dispatchNodeNotification<&OpenZWaveBackend::onNodeNaming>;
+        handlers[OpenZWave::Notification::Type_DriverReady] = &OpenZWaveBackend::dispatchNetworkNotification<&OpenZWaveBackend::onDriverReady>;
+        handlers[OpenZWave::Notification::Type_NodeNew] = &OpenZWaveBackend::dispatchNodeNotification<&OpenZWaveBackend::onNewNode>;
+        handlers[OpenZWave::Notification::Type_NodeAdded] = &OpenZWaveBackend::dispatchNodeNotification<&OpenZWaveBackend::onNodeAdded>;
+        handlers[OpenZWave::Notification::Type_NodeRemoved] = &OpenZWaveBackend::dispatchNodeNotification<&OpenZWaveBackend::onNodeRemoved>;
+        handlers[OpenZWave::Notification::Type_NodeProtocolInfo] = &OpenZWaveBackend::dispatchNodeNotification<&OpenZWaveBackend::onNodeProtocolInfoReceived>;
+        handlers[OpenZWave::Notification::Type_Notification] = &OpenZWaveBackend::dispatchZWaveNotification;
+        handlers[OpenZWave::Notification::Type_EssentialNodeQueriesComplete] = &OpenZWaveBackend::dispatchNetworkNotification<&OpenZWaveBackend::onEssentialNodeQueriesComplete>;
+        handlers[OpenZWave::Notification::Type_NodeQueriesComplete] = &OpenZWaveBackend::dispatchNodeNotification<&OpenZWaveBackend::onNodeQueryComplete>;
+        handlers[OpenZWave::Notification::Type_AwakeNodesQueried] = &OpenZWaveBackend::dispatchNetworkNotification<&OpenZWaveBackend::onAwakeNodesQueried>;
+        handlers[OpenZWave::Notification::Type_AllNodesQueriedSomeDead] = &OpenZWaveBackend::dispatchNetworkNotification<&OpenZWaveBackend::onAllNodesQueried>;
+        handlers[OpenZWave::Notification::Type_AllNodesQueried] = &OpenZWaveBackend::dispatchNetworkNotification<&OpenZWaveBackend::onAllNodesQueried>;
+        handlers[OpenZWave::Notification::Type_DriverRemoved] = &OpenZWaveBackend::dispatchNetworkNotification<&OpenZWaveBackend::onDriverRemoved>;
+        handlers[OpenZWave::Notification::Type_DriverFailed] = &OpenZWaveBackend::dispatchDriverFailed;
+        handlers[OpenZWave::Notification::Type_ControllerCommand] = &OpenZWaveBackend::dispatchControllerCommand;
+        handlers[OpenZWave::Notification::Type_Group] = &OpenZWaveBackend::dispatchGroup;
+        handlers[OpenZWave::Notification::Type_NodeEvent] = &OpenZWaveBackend::dispatchNodeEvent;
+#ifdef OZW_16
+        handlers[OpenZWave::Notification::Type_UserAlerts] = &OpenZWaveBackend::dispatchUserAlert;
+#endif
+    }
+
+    NotificationHandler handlers[Size];
+};
+
+void OpenZWaveBackend::processNotification(const OpenZWaveNotificationRecord &record)
+{
+    static const NotificationDispatchTable table;
+
+    NotificationHandler handler = record.type < NotificationDispatchTable::Size ? table.handlers[record.type] : nullptr;
+    if (!handler) {
+        qCWarning(dcOpenZWave()) << "Unhandled notification record" << record.type;
+        return;
+    }
+    (this->*handler)(record);
+}
+
+template <void (OpenZWaveBackend::*handler)(quint32)>
+void OpenZWaveBackend::dispatchNetworkNotification(const OpenZWaveNotificationRecord &record)
+{
+    (this->*handler)(record.homeId);
+}
+
+template <void (OpenZWaveBackend::*handler)(quint32, quint8)>
+void OpenZWaveBackend::dispatchNodeNotification(const OpenZWaveNotificationRecord &record)
+{
+    (this->*handler)(record.homeId, record.nodeId);
+}
+
+void OpenZWaveBackend::dispatchValueAdded(const OpenZWaveNotificationRecord &record)
+{
+    OpenZWave::ValueID valueId(record.homeId, record.valueId);
+    onValueAdded(record.homeId, record.nodeId, record.valueId,
+                 static_cast<ZWaveValue::Genre>(valueId.GetGenre()),
+                 static_cast<ZWaveValue::CommandClass>(valueId.GetCommandClassId()),
+                 valueId.GetInstance(),
+                 valueId.GetIndex(),
+                 static_cast<ZWaveValue::Type>(valueId.GetType()));
+}
+
+void OpenZWaveBackend::dispatchValueChanged(const OpenZWaveNotificationRecord &record)
+{
+    OpenZWave::ValueID valueId(record.homeId, record.valueId);
+    onValueChanged(record.homeId, record.nodeId, record.valueId,
+                   static_cast<ZWaveValue::Genre>(valueId.GetGenre()),
+                   static_cast<ZWaveValue::CommandClass>(valueId.GetCommandClassId()),
+                   valueId.GetInstance(),
+                   valueId.GetIndex(),
+                   static_cast<ZWaveValue::Type>(valueId.GetType()));
+}
+
+void OpenZWaveBackend::dispatchValueRefreshed(const OpenZWaveNotificationRecord &record)
+{
+    OpenZWave::ValueID valueId(record.homeId, record.valueId);
+    onValueRefreshed(record.homeId, record.nodeId, record.valueId,
+                     static_cast<ZWaveValue::Genre>(valueId.GetGenre()),
+                     static_cast<ZWaveValue::CommandClass>(valueId.GetCommandClassId()),
+                     valueId.GetInstance(),
+                     valueId.GetIndex(),
+                     static_cast<ZWaveValue::Type>(valueId.GetType()));
+}
+
+void OpenZWaveBackend::dispatchValueRemoved(const OpenZWaveNotificationRecord &record)
+{
+    onValueRemoved(record.homeId, record.nodeId, record.valueId);
+}
+
+void OpenZWaveBackend::dispatchDriverFailed(const OpenZWaveNotificationRecord &record)
+{
+#ifdef OZW_16
+    m_failedSerialPortsMutex.lock();
+    QString serialPort = m_failedSerialPorts.take(record.valueId);
+    m_failedSerialPortsMutex.unlock();
+    onDriverFailed(serialPort);
+#else
+    Q_UNUSED(record)
+    onDriverFailed();
+#endif
+}
+
+#ifdef OZW_16
+quint64 OpenZWaveBackend::parkFailedSerialPort(const QString &serialPort)
+{
+    QMutexLocker locker(&m_failedSerialPortsMutex);
+    quint64 index = ++m_failedSerialPortIndex;
+    m_failedSerialPorts.insert(index, serialPort);
+    return index;
+}
+#endif
+
+void OpenZWaveBackend::dispatchZWaveNotification(const OpenZWaveNotificationRecord &record)
+{
+    onZWaveNotification(record.homeId, record.nodeId, static_cast<NotificationCode>(record.code));
+}
+
+void OpenZWaveBackend::dispatchControllerCommand(const OpenZWaveNotificationRecord &record)
+{
+    onControllerCommand(record.homeId, static_cast<ControllerCommand>(record.command), static_cast<ControllerState>(record.code));
+}
+
+// Only logged, but queued like everything else so they show up in traces and the event ring
+void OpenZWaveBackend::dispatchGroup(const OpenZWaveNotificationRecord &record)
+{
+    qCDebug(dcOpenZWave) << "Group information changed for node" << record.nodeId << "in network" << record.homeId;
+}
+
+void OpenZWaveBackend::dispatchNodeEvent(const OpenZWaveNotificationRecord &record)
+{
+    qCWarning(dcOpenZWave()) << "Node event:" << record.code << "from node" << record.nodeId << "in network" << record.homeId;
+}
+
+#ifdef OZW_16
+void OpenZWaveBackend::dispatchUserAlert(const OpenZWaveNotificationRecord &record)
+{
+    qCWarning(dcOpenZWave()) << "OpenZWave user alert:" << static_cast<UserAlertNotification>(record.code) << "for node" << record.nodeId << "in network" << record.homeId;
+}
+#endif
+
+OpenZWaveNotificationQueue::Statistics OpenZWaveBackend::notificationQueueStatistics() const
+{
+    return m_notificationQueue.statistics();
+}
+
+bool OpenZWaveBackend::startTrace(const QString &fileName)
+{
+    if (!m_trace.open(fileName)) {
+        qCWarning(dcOpenZWave()) << "Cannot open notification trace" << fileName;
+        return false;
+    }
+    qCInfo(dcOpenZWave()) << "Tracing notifications to" << fileName;
+    return true;
+}
+
+void OpenZWaveBackend::stopTrace()
+{
+    if (m_trace.isOpen()) {
+        qCInfo(dcOpenZWave()) << "Notification trace stopped after" << m_trace.count() << "notifications";
+        m_trace.close();
+    }
+}
+
+bool OpenZWaveBackend::isTracing() const
+{
+    return m_trace.isOpen();
+}
+
+OpenZWaveDispatchStatistics OpenZWaveBackend::dispatchStatistics(const QUuid &networkUuid) const
+{
+    if (networkUuid.isNull()) {
+        return m_dispatchStatistics;
+    }
+    OpenZWaveNetwork *network = m_networks.value(networkUuid);
+    if (!network) {
+        return OpenZWaveDispatchStatistics();
+    }
+    return network->dispatchStatistics;
+}
+
+void OpenZWaveBackend::resetDispatchStatistics()
+{
+    m_dispatchStatistics.reset();
+    foreach (OpenZWaveNetwork *network, m_networks) {
+        network->dispatchStatistics.reset();
+    }
+}
+
+void OpenZWaveBackend::setDispatchStatisticsDumpInterval(int msecs)
+{
+    if (msecs > 0) {
+        m_dispatchStatisticsDumpTimer.start(msecs);
+    } else {
+        m_dispatchStatisticsDumpTimer.stop();
+    }
+}
+
+void OpenZWaveBackend::dumpDispatchStatistics()
+{
+    OpenZWaveNotificationQueue::Statistics queue = m_notificationQueue.statistics();
+    qCInfo(dcOpenZWave()) << "Notification queue: enqueued" << queue.enqueued << "overflows" << queue.overflows << "max batch" << queue.maxBatchSize;
+    foreach (OpenZWaveNetwork *network, m_networks) {
+        qCInfo(dcOpenZWave()).noquote() << "Network" << network->homeId << network->dispatchStatistics.toString();
+    }
+    if (m_dispatchStatistics.queueDelay().count() > 0) {
+        qCInfo(dcOpenZWave()).noquote() << "No network" << m_dispatchStatistics.toString();
+    }
+}
+
+OpenZWaveValueCoalescer *OpenZWaveBackend::valueCoalescer()
+{
+    return &m_valueCoalescer;
+}
+
+quint64 OpenZWaveBackend::unchangedRefreshCount() const
+{
+    return m_unchangedRefreshes;
+}
+
 void OpenZWaveBackend::onDriverReady(quint32 homeId)
 {
     if (m_pendingNetworkSetups.isEmpty()) {
@@ -679,36 +1695,112 @@ void OpenZWaveBackend::onDriverReady(quint32 homeId)
         return;
     }
 
-    // Note: OZW doesn't give us any way to match this callback with an AddDriver call ¯\_(ツ)_/¯
-    // So we'll just use the first pending network uuid
-    // If the user creates 2 new networks and callbacks return in a different order, this will fail...
-    qCDebug(dcOpenZWave) << "Network ready with homeId" << homeId;
+    // The driver knows which serial port it has been added for, so several sticks can start at once. Only an
+    // AddDriver timeout can't be attributed while more than one of them is starting, see onZWaveNotification().
+    QString serialPort = QString::fromStdString(m_manager->GetControllerPath(homeId));
+    qCDebug(dcOpenZWave) << "Network ready with homeId" << homeId << "on" << serialPort;
 #ifdef OZW_16
     qCDebug(dcOpenZWave) << "Controller" << (m_manager->HasExtendedTxStatus(homeId) ? "supports" : "does not support") << "extended TxStatus reporting.";
 #endif
-    QUuid networkUuid = m_pendingNetworkSetups.takeFirst();
-    m_homeIds.insert(networkUuid, homeId);
-    emit networkStarted(m_homeIds.key(homeId));
+    QUuid networkUuid = takePendingNetworkSetup(serialPort);
+    if (networkUuid.isNull()) {
+        qCWarning(dcOpenZWave()) << "No pending network setup for serial port" << serialPort << "- ignoring driver ready for home id" << homeId;
+        return;
+    }
+    finishNetworkSetup(networkUuid);
+    OpenZWaveNetwork *network = m_networks.value(networkUuid);
+    if (!network) {
+        qCWarning(dcOpenZWave()) << "Network" << networkUuid.toString() << "has been stopped in the meantime";
+        return;
+    }
+    // A factory reset brings the driver up again with a new home id, nothing known so far exists any more
+    if (network->homeId != 0 && network->homeId != homeId) {
+        qCInfo(dcOpenZWave()) << "Home id of network" << networkUuid.toString() << "changed from" << network->homeId << "to" << homeId;
+        dropAllNodes(network);
+    }
+    m_networksByHomeId.remove(network->homeId);
+    network->homeId = homeId;
+    m_networksByHomeId.insert(homeId, network);
+
+    if (network->driverAdded >= 0) {
+        qint64 duration = m_clock.elapsed() - network->driverAdded;
+        StartupTimes &times = network->warmStart ? m_warmStartTimes : m_coldStartTimes;
+        times.count++;
+        times.last = duration;
+        times.max = qMax(times.max, duration);
+        times.total += duration;
+        network->driverAdded = -1;
+        qCInfo(dcOpenZWave()) << "Driver ready after" << duration << "ms" << (network->warmStart ? "(warm start)" : "(cold start)");
+    }
+    if (network->snapshotHomeId != 0 && network->snapshotHomeId != homeId) {
+        qCInfo(dcOpenZWave()) << "Snapshot of network" << networkUuid.toString() << "was taken for home id" << network->snapshotHomeId << "instead of" << homeId;
+        discardSnapshot(network);
+    }
+    emit networkStarted(network->networkUuid);
+}
+
+void OpenZWaveBackend::dropAllNodes(OpenZWaveNetwork *network)
+{
+    QSet<quint8> nodeIds = network->nodeIds;
+    nodeIds.unite(network->snapshotNodes);
+    foreach (quint8 nodeId, network->values.keys()) {
+        nodeIds.insert(nodeId);
+    }
+    foreach (quint8 nodeId, nodeIds) {
+        dropNode(network, nodeId);
+    }
+    // Node info may also have been fetched for nodes which never showed up
+    for (int nodeId = 1; nodeId <= OpenZWaveNetwork::MaxNodes; nodeId++) {
+        network->invalidateNodeInfo(nodeId);
+    }
+    network->metadata.clear();
+    network->snapshotHomeId = 0;
+    network->snapshotValues.clear();
+    network->driverMonitor.reset();
+}
+
+QUuid OpenZWaveBackend::takePendingNetworkSetup(const QString &serialPort)
+{
+    for (int i = 0; i < m_pendingNetworkSetups.count(); i++) {
+        OpenZWaveNetwork *network = m_networks.value(m_pendingNetworkSetups.at(i));
+        if (network && network->serialPort == serialPort) {
+            return m_pendingNetworkSetups.takeAt(i);
+        }
+    }
+    // Shouldn't happen, unless the port has been given in a different notation. Guessing could hand the home id
+    // to the wrong network while several are starting up.
+    return QUuid();
 }
 
 #ifdef OZW_16
 void OpenZWaveBackend::onDriverFailed(const QString &serialPort)
 {
-    if (!m_serialPorts.values().contains(serialPort)) {
-        qCWarning(dcOpenZWave()) << "Received a driver failed callback for a serial port we don't know:" << serialPort;
-        return;
+    foreach (OpenZWaveNetwork *network, m_networks) {
+        if (network->serialPort == serialPort) {
+            qCWarning(dcOpenZWave()) << "Driver failed for serial port" << serialPort;
+            recordEvent(OpenZWaveEventRing::EventDriverFailed, network->homeId);
+            dumpEventTraceOnFault();
+            finishNetworkSetup(network->networkUuid);
+            emit networkFailed(network->networkUuid);
+            return;
+        }
     }
-    qCWarning(dcOpenZWave()) << "Driver failed for serial port" << serialPort;
-    emit networkFailed(m_serialPorts.key(serialPort));
+    qCWarning(dcOpenZWave()) << "Received a driver failed callback for a serial port we don't know:" << serialPort;
 }
 #else
 void OpenZWaveBackend::onDriverFailed()
 {
     // Note: OZW < 1.6 doesn't give us any way to match this callback with an AddDriver call ¯\_(ツ)_/¯
-    // So we'll just use the first pending network uuid
-    // If the user creates 2 new networks and callbacks return in a different order, this will fail...
+    // That's why drivers are only added one at a time, see addDriver(), so it's the one pending setup.
     qCDebug(dcOpenZWave) << "Driver failed";
-    QUuid networkUuid = m_pendingNetworkSetups.takeFirst();
+    recordEvent(OpenZWaveEventRing::EventDriverFailed, 0);
+    dumpEventTraceOnFault();
+    if (m_pendingNetworkSetups.isEmpty()) {
+        qCWarning(dcOpenZWave()) << "Received a driver failed callback but we're not waiting for one!";
+        return;
+    }
+    QUuid networkUuid = m_pendingNetworkSetups.first();
+    finishNetworkSetup(networkUuid);
     emit networkFailed(networkUuid);
 }
 #endif
@@ -727,94 +1819,230 @@ void OpenZWaveBackend::onDriverRemoved(quint32 homeId)
 // properly.
 void OpenZWaveBackend::onNewNode(quint32 homeId, quint8 nodeId)
 {
-    if (!m_homeIds.values().contains(homeId)) {
+    OpenZWaveNetwork *network = m_networksByHomeId.value(homeId);
+    if (!network) {
         qCWarning(dcOpenZWave()) << "Received a new node callback for a network we don't know:" << homeId;
         return;
     }
     qCInfo(dcOpenZWave()) << "New node" << nodeId << "for network" << homeId;
-    emit nodeAdded(m_homeIds.key(homeId), nodeId);
+    network->nodeIds.insert(nodeId);
+    network->snapshotNodes.remove(nodeId);
+    emit nodeAdded(network->networkUuid, nodeId);
 }
 
 void OpenZWaveBackend::onNodeAdded(quint32 homeId, quint8 nodeId)
 {
-    if (!m_homeIds.values().contains(homeId)) {
+    OpenZWaveNetwork *network = m_networksByHomeId.value(homeId);
+    if (!network) {
         qCWarning(dcOpenZWave()) << "Received a node added callback for a network we don't know:" << homeId;
         return;
     }
     qCInfo(dcOpenZWave()) << "Node" << nodeId << "added to network" << homeId;
-    emit nodeAdded(m_homeIds.key(homeId), nodeId);
+    network->nodeIds.insert(nodeId);
+    network->snapshotNodes.remove(nodeId);
+    emit nodeAdded(network->networkUuid, nodeId);
 }
 
 void OpenZWaveBackend::onNodeNaming(quint32 homeId, quint8 nodeId)
 {
-    if (!m_homeIds.values().contains(homeId)) {
+    OpenZWaveNetwork *network = m_networksByHomeId.value(homeId);
+    if (!network) {
         qCWarning(dcOpenZWave()) << "Received a node naming callback for a network we don't know:" << homeId;
         return;
     }
     qCInfo(dcOpenZWave()) << "Node names changed for node" << nodeId << "in network" << homeId;
-    emit nodeDataChanged(m_homeIds.key(homeId), nodeId);
+    network->invalidateNodeInfo(nodeId);
+    emit nodeDataChanged(network->networkUuid, nodeId);
 }
 
 void OpenZWaveBackend::onNodeRemoved(quint32 homeId, quint8 nodeId)
 {
-    if (!m_homeIds.values().contains(homeId)) {
+    OpenZWaveNetwork *network = m_networksByHomeId.value(homeId);
+    if (!network) {
         qCWarning(dcOpenZWave()) << "Received a node naming callback for a network we don't know:" << homeId;
         return;
     }
     qCInfo(dcOpenZWave()) << "Node" << nodeId << "removed from network" << homeId;
-    emit nodeRemoved(m_homeIds.key(homeId), nodeId);
+    dropNode(network, nodeId);
+}
+
+void OpenZWaveBackend::dropNode(OpenZWaveNetwork *network, quint8 nodeId)
+{
+    foreach (quint64 valueId, network->values.value(nodeId).keys()) {
+        network->metadata.remove(valueId);
+        network->snapshotValues.remove(valueId);
+    }
+    network->snapshotNodes.remove(nodeId);
+    network->nodeIds.remove(nodeId);
+    network->values.remove(nodeId);
+    network->linkQualitySampler.reset(nodeId);
+    network->nodeStatistics.removeNode(nodeId);
+    network->healScheduler.removeNode(nodeId);
+    network->pollingEngine.removeNode(nodeId);
+    network->wakeUpQueue.dropNode(nodeId);
+    network->invalidateNodeInfo(nodeId);
+    m_valueCoalescer.dropNode(network->networkUuid, nodeId);
+    finishPendingWrites(network->writeTracker.takeNode(nodeId, m_clock.elapsed(), false), ZWave::ZWaveErrorBackendError);
+    emit nodeRemoved(network->networkUuid, nodeId);
 }
 
 void OpenZWaveBackend::onValueAdded(quint32 homeId, quint8 nodeId, quint64 id, ZWaveValue::Genre genre, ZWaveValue::CommandClass commandClass, quint8 instance, quint16 index, ZWaveValue::Type type)
 {
-    if (!m_homeIds.values().contains(homeId)) {
+    OpenZWaveNetwork *network = m_networksByHomeId.value(homeId);
+    if (!network) {
         qCWarning(dcOpenZWave()) << "Received a value added callback for a network we don't know:" << homeId;
         return;
     }
     qCDebug(dcOpenZWave()) << "Value" << id << "added to node" << nodeId << "in network" << homeId;
-    emit valueAdded(m_homeIds.key(homeId), nodeId, readValue(homeId, nodeId, id, genre, commandClass, instance, index, type));
-    updateNodeLinkQuality(homeId, nodeId);
+    ZWaveValue value = readValue(network, nodeId, id, genre, commandClass, instance, index, type);
+    // Values already presented from the snapshot are only updated
+    bool fromSnapshot = network->snapshotValues.remove(id);
+    ZWaveValue snapshotValue = fromSnapshot ? network->values.value(nodeId).value(id) : ZWaveValue();
+    network->values[nodeId].insert(id, value);
+
+    OpenZWave::ValueID valueId(homeId, id);
+    if (m_manager->IsPolled(valueId)) {
+        network->pollingEngine.addValue(id, nodeId, m_manager->GetPollIntensity(valueId));
+    }
+
+    if (!fromSnapshot) {
+        emit valueAdded(network->networkUuid, nodeId, value);
+    } else if (value.value() != snapshotValue.value() || value.valueListSelection() != snapshotValue.valueListSelection()) {
+        emit valueChanged(network->networkUuid, nodeId, value);
+    }
+    updateNodeLinkQuality(network, nodeId);
 }
 
 void OpenZWaveBackend::onValueChanged(quint32 homeId, quint8 nodeId, quint64 id, ZWaveValue::Genre genre, ZWaveValue::CommandClass commandClass, quint8 instance, quint16 index, ZWaveValue::Type type)
 {
-    if (!m_homeIds.values().contains(homeId)) {
+    OpenZWaveNetwork *network = m_networksByHomeId.value(homeId);
+    if (!network) {
         qCWarning(dcOpenZWave()) << "Received a value changed callback for a network we don't know:" << homeId;
         return;
     }
-    QUuid networkUuid = m_homeIds.key(homeId);
+    QUuid networkUuid = network->networkUuid;
     qCDebug(dcOpenZWave()) << "Value" << id << "changed for node" << nodeId << "in network" << homeId;
-    emit valueChanged(networkUuid, nodeId, readValue(homeId, nodeId, id, genre, commandClass, instance, index, type));
+
+    const ZWaveValue &value = updateValue(network, nodeId, id, genre, commandClass, instance, index, type);
+    finishPendingWrites(network->writeTracker.takeValue(id, m_clock.elapsed(), true), ZWave::ZWaveErrorNoError);
+    setPollIntensity(network, id, network->pollingEngine.valueReported(id, true));
+    if (!m_valueCoalescer.submit(networkUuid, nodeId, value)) {
+        emit valueChanged(networkUuid, nodeId, value);
+    }
 
     // emitting node reachable because the appropriate notification doesn't always seem to come in, even if we're talking to the device
     emit nodeReachableStatus(networkUuid, nodeId, true);
 
-    updateNodeLinkQuality(homeId, nodeId);
+    updateNodeLinkQuality(network, nodeId);
+}
+
+// Polls and refresh requests end up here, mostly with unchanged values. Only actual changes are emitted as
+// valueChanged, the others are reported with the lightweight valueRefreshed signal.
+void OpenZWaveBackend::onValueRefreshed(quint32 homeId, quint8 nodeId, quint64 id, ZWaveValue::Genre genre, ZWaveValue::CommandClass commandClass, quint8 instance, quint16 index, ZWaveValue::Type type)
+{
+    OpenZWaveNetwork *network = m_networksByHomeId.value(homeId);
+    if (!network) {
+        qCWarning(dcOpenZWave()) << "Received a value refreshed callback for a network we don't know:" << homeId;
+        return;
+    }
+    QUuid networkUuid = network->networkUuid;
+
+    bool changed = false;
+    const ZWaveValue &value = updateValue(network, nodeId, id, genre, commandClass, instance, index, type, &changed);
+    // The device confirmed the value, whether it actually changed or not
+    finishPendingWrites(network->writeTracker.takeValue(id, m_clock.elapsed(), true), ZWave::ZWaveErrorNoError);
+    setPollIntensity(network, id, network->pollingEngine.valueReported(id, changed));
+    if (changed) {
+        qCDebug(dcOpenZWave()) << "Value" << id << "refreshed with a new value for node" << nodeId << "in network" << homeId;
+        if (!m_valueCoalescer.submit(networkUuid, nodeId, value)) {
+            emit valueChanged(networkUuid, nodeId, value);
+        }
+    } else {
+        m_unchangedRefreshes++;
+        emit valueRefreshed(networkUuid, nodeId, id);
+    }
+
+    emit nodeReachableStatus(networkUuid, nodeId, true);
+
+    updateNodeLinkQuality(network, nodeId);
+}
+
+const ZWaveValue &OpenZWaveBackend::updateValue(OpenZWaveNetwork *network, quint8 nodeId, quint64 id, ZWaveValue::Genre genre, ZWaveValue::CommandClass commandClass, quint8 instance, quint16 index, ZWaveValue::Type type, bool *changed)
+{
+    // Only the actual value changes, the rest of the shadow copy is still valid
+    QHash<quint64, ZWaveValue> &nodeValues = network->values[nodeId];
+    QHash<quint64, ZWaveValue>::iterator it = nodeValues.find(id);
+    if (it == nodeValues.end()) {
+        it = nodeValues.insert(id, readValue(network, nodeId, id, genre, commandClass, instance, index, type));
+        if (changed) {
+            *changed = true;
+        }
+        return it.value();
+    }
+
+    ZWaveValue &value = it.value();
+    QVariant previousValue = value.value();
+    int previousSelection = value.valueListSelection();
+
+    readValueData(OpenZWave::ValueID(network->homeId, id), network->metadata[id], value);
+
+    if (changed) {
+        *changed = value.value() != previousValue || value.valueListSelection() != previousSelection;
+    }
+    return value;
+}
+
+void OpenZWaveBackend::setPollIntensity(OpenZWaveNetwork *network, quint64 valueId, quint8 intensity)
+{
+    if (intensity == 0) {
+        return;
+    }
+    qCDebug(dcOpenZWave()) << "Polling value" << valueId << "every" << intensity << "poll cycles";
+    // Only changes the poll list of OpenZWave and doesn't send anything, so there's nothing to schedule.
+    // Applied right away, a write resets the intensity before the poll thread picks the value again.
+    try {
+        m_manager->SetPollIntensity(OpenZWave::ValueID(network->homeId, valueId), intensity);
+    } catch (const OpenZWave::OZWException &e) {
+        qCWarning(dcOpenZWave()) << "Error setting poll intensity:" << e.what();
+    }
 }
 
 void OpenZWaveBackend::onValueRemoved(quint32 homeId, quint8 nodeId, quint64 id)
 {
-    if (!m_homeIds.values().contains(homeId)) {
+    OpenZWaveNetwork *network = m_networksByHomeId.value(homeId);
+    if (!network) {
         qCWarning(dcOpenZWave()) << "Received a value changed callback for a network we don't know:" << homeId;
         return;
     }
     qCDebug(dcOpenZWave()) << "Value" << id << "removed from node" << nodeId << "in network" << homeId;
-    emit valueRemoved(m_homeIds.key(homeId), nodeId, id);
+    QHash<quint8, QHash<quint64, ZWaveValue> >::iterator it = network->values.find(nodeId);
+    if (it != network->values.end()) {
+        it.value().remove(id);
+    }
+    network->metadata.remove(id);
+    network->pollingEngine.removeValue(id);
+    network->wakeUpQueue.dropValue(nodeId, id);
+    network->snapshotValues.remove(id);
+    m_valueCoalescer.drop(network->networkUuid, id);
+    emit valueRemoved(network->networkUuid, nodeId, id);
 }
 
 void OpenZWaveBackend::onNodeProtocolInfoReceived(quint32 homeId, quint8 nodeId)
 {
-    if (!m_homeIds.values().contains(homeId)) {
+    OpenZWaveNetwork *network = m_networksByHomeId.value(homeId);
+    if (!network) {
         qCWarning(dcOpenZWave()) << "Received a node proticol info callback for a network we don't know:" << homeId;
         return;
     }
     qCInfo(dcOpenZWave()) << "Protocol info changed for node" << nodeId << "in network" << homeId;
-    emit nodeDataChanged(m_homeIds.key(homeId), nodeId);
+    fillNodeInfo(network, nodeId);
+    emit nodeDataChanged(network->networkUuid, nodeId);
 }
 
 void OpenZWaveBackend::onEssentialNodeQueriesComplete(quint32 homeId)
 {
-    if (!m_homeIds.values().contains(homeId)) {
+    OpenZWaveNetwork *network = m_networksByHomeId.value(homeId);
+    if (!network) {
         qCWarning(dcOpenZWave()) << "Received a node queries complete callback for a network we don't know:" << homeId;
         return;
     }
@@ -823,18 +2051,20 @@ void OpenZWaveBackend::onEssentialNodeQueriesComplete(quint32 homeId)
 
 void OpenZWaveBackend::onNodeQueryComplete(quint32 homeId, quint8 nodeId)
 {
-    if (!m_homeIds.values().contains(homeId)) {
+    OpenZWaveNetwork *network = m_networksByHomeId.value(homeId);
+    if (!network) {
         qCWarning(dcOpenZWave()) << "Received a node query complete callback for a network we don't know:" << homeId;
         return;
     }
     qCDebug(dcOpenZWave()) << "Node query complete for node" << nodeId << "in network" << homeId;
-    emit nodeInitialized(m_homeIds.key(homeId), nodeId);
-    nodeIsSecureDevice(m_homeIds.key(homeId), nodeId);
+    fillNodeInfo(network, nodeId);
+    emit nodeInitialized(network->networkUuid, nodeId);
 }
 
 void OpenZWaveBackend::onAwakeNodesQueried(quint32 homeId)
 {
-    if (!m_homeIds.values().contains(homeId)) {
+    OpenZWaveNetwork *network = m_networksByHomeId.value(homeId);
+    if (!network) {
         qCWarning(dcOpenZWave()) << "Received an awake nodes queried callback for a network we don't know:" << homeId;
         return;
     }
@@ -843,53 +2073,75 @@ void OpenZWaveBackend::onAwakeNodesQueried(quint32 homeId)
 
 void OpenZWaveBackend::onAllNodesQueried(quint32 homeId)
 {
-    if (!m_homeIds.values().contains(homeId)) {
+    OpenZWaveNetwork *network = m_networksByHomeId.value(homeId);
+    if (!network) {
         qCWarning(dcOpenZWave()) << "Received an all nodes queried callback for a network we don't know:" << homeId;
         return;
     }
     qCDebug(dcOpenZWave) << "All nodes queried in network" << homeId;
+    discardSnapshot(network);
+    saveSnapshot(network);
 }
 
 void OpenZWaveBackend::onZWaveNotification(quint32 homeId, quint8 nodeId, NotificationCode code)
 {
     if (homeId == 0) {
-        if (code == NotificationCodeTimeout && m_pendingNetworkSetups.count() > 0) {
-            QUuid networkUuid = m_pendingNetworkSetups.takeFirst();
-            qCWarning(dcOpenZWave()) << "AddDriver timed out for network" << networkUuid.toString();
-            m_manager->RemoveDriver(m_serialPorts.value(networkUuid).toStdString());
-            emit networkFailed(networkUuid);
+        // Unlike DriverReady and DriverFailed, this doesn't tell the driver it is about. With several drivers
+        // starting up it can't be attributed, so instead of guessing all of them fail and can be started again.
+        if (code == NotificationCodeTimeout && !m_pendingNetworkSetups.isEmpty()) {
+            QList<QUuid> networkUuids = m_pendingNetworkSetups;
+            if (networkUuids.count() > 1) {
+                qCWarning(dcOpenZWave()) << "AddDriver timed out for one of" << networkUuids.count() << "networks starting up, failing all of them";
+            }
+            foreach (const QUuid &networkUuid, networkUuids) {
+                qCWarning(dcOpenZWave()) << "AddDriver timed out for network" << networkUuid.toString();
+                OpenZWaveNetwork *network = m_networks.value(networkUuid);
+                if (network) {
+                    m_manager->RemoveDriver(network->serialPort.toStdString());
+                }
+                finishNetworkSetup(networkUuid);
+                emit networkFailed(networkUuid);
+            }
             return;
         }
     }
-    if (!m_homeIds.values().contains(homeId)) {
+    OpenZWaveNetwork *network = m_networksByHomeId.value(homeId);
+    if (!network) {
         qCWarning(dcOpenZWave()) << "Received a zwave notification callback for a network we don't know:" << homeId << code;
         return;
     }
 
     switch (code) {
+    case NotificationCodeMsgComplete:
+        // Also completes polls and other requests, only writes whose own message can be the one are finished
+        finishPendingWrites(network->writeTracker.takeCompletedMessage(nodeId, m_clock.elapsed()), ZWave::ZWaveErrorNoError);
+        break;
     case NotificationCodeDead:
         qCDebug(dcOpenZWave) << "Node" << nodeId << "in network" << homeId << "is dead";
-        emit nodeFailedStatus(m_homeIds.key(homeId), nodeId, true);
-        emit nodeReachableStatus(m_homeIds.key(homeId), nodeId, false);
+        finishPendingWrites(network->writeTracker.takeNode(nodeId, m_clock.elapsed(), false), ZWave::ZWaveErrorBackendError);
+        emit nodeFailedStatus(network->networkUuid, nodeId, true);
+        emit nodeReachableStatus(network->networkUuid, nodeId, false);
         break;
     case NotificationCodeTimeout:
         qCDebug(dcOpenZWave) << "Node timeout for node" << nodeId << "in network" << homeId;
-        emit nodeReachableStatus(m_homeIds.key(homeId), nodeId, false);
+        finishPendingWrites(network->writeTracker.takeNode(nodeId, m_clock.elapsed(), false), ZWave::ZWaveErrorBackendError);
+        emit nodeReachableStatus(network->networkUuid, nodeId, false);
         break;
     case NotificationCodeAlive:
         qCDebug(dcOpenZWave) << "Node" << nodeId << "in network" << homeId << "is alive";
-        emit nodeReachableStatus(m_homeIds.key(homeId), nodeId, true);
+        emit nodeReachableStatus(network->networkUuid, nodeId, true);
         break;
     case NotificationCodeNoOperation:
         qCDebug(dcOpenZWave()) << "NoOperation command sent to node:" << nodeId << "in network" << homeId;
         break;
     case NotificationCodeSleep:
         qCDebug(dcOpenZWave()) << "Node" << nodeId << "in network" << homeId << "is sleeping";
-        emit nodeSleepStatus(m_homeIds.key(homeId), nodeId, true);
+        emit nodeSleepStatus(network->networkUuid, nodeId, true);
         break;
     case NotificationCodeAwake:
         qCDebug(dcOpenZWave()) << "Node" << nodeId << "in network" << homeId << "is awake";
-        emit nodeSleepStatus(m_homeIds.key(homeId), nodeId, false);
+        emit nodeSleepStatus(network->networkUuid, nodeId, false);
+        flushPendingWrites(network, nodeId);
         break;
     default:
         qCWarning(dcOpenZWave()) << "Unhandled ZWave notification code:" << code << "for node" << nodeId << "in network" << homeId;
@@ -898,7 +2150,8 @@ void OpenZWaveBackend::onZWaveNotification(quint32 homeId, quint8 nodeId, Notifi
 
 void OpenZWaveBackend::onControllerCommand(quint32 homeId, ControllerCommand command, ControllerState state)
 {
-    if (!m_homeIds.values().contains(homeId)) {
+    OpenZWaveNetwork *network = m_networksByHomeId.value(homeId);
+    if (!network) {
         qCWarning(dcOpenZWave()) << "Received a controller command callback for a network we don't know:" << homeId;
         return;
     }
@@ -910,6 +2163,7 @@ void OpenZWaveBackend::onControllerCommand(quint32 homeId, ControllerCommand com
     // for and hope it lines up...
     command = m_controllerCommand;
 #endif
+    recordEvent(OpenZWaveEventRing::EventControllerCommand, homeId, 0, 0, command, state);
 
 
     switch (command) {
@@ -927,10 +2181,10 @@ void OpenZWaveBackend::onControllerCommand(quint32 homeId, ControllerCommand com
             if (m_pendingControllerCommands.contains(homeId)) {
                 finishReply(m_pendingControllerCommands.take(homeId), ZWave::ZWaveErrorNoError);
             }
-            emit waitingForNodeAdditionChanged(m_homeIds.key(homeId), true);
+            emit waitingForNodeAdditionChanged(network->networkUuid, true);
         } else if (state == ControllerStateCompleted) {
             qCInfo(dcOpenZWave()) << "Node addition completed in network" << homeId;
-            emit waitingForNodeAdditionChanged(m_homeIds.key(homeId), false);
+            emit waitingForNodeAdditionChanged(network->networkUuid, false);
 #ifndef OZW_16
             m_controllerCommand = ControllerCommandNone;
 #endif
@@ -952,10 +2206,10 @@ void OpenZWaveBackend::onControllerCommand(quint32 homeId, ControllerCommand com
             if (m_pendingControllerCommands.contains(homeId)) {
                 finishReply(m_pendingControllerCommands.take(homeId), ZWave::ZWaveErrorNoError);
             }
-            emit waitingForNodeRemovalChanged(m_homeIds.key(homeId), true);
+            emit waitingForNodeRemovalChanged(network->networkUuid, true);
         } else if (state == ControllerStateCompleted) {
             qCInfo(dcOpenZWave()) << "Node removal completed in network" << homeId;
-            emit waitingForNodeRemovalChanged(m_homeIds.key(homeId), false);
+            emit waitingForNodeRemovalChanged(network->networkUuid, false);
 #ifndef OZW_16
             m_controllerCommand = ControllerCommandNone;
 #endif
@@ -963,6 +2217,16 @@ void OpenZWaveBackend::onControllerCommand(quint32 homeId, ControllerCommand com
             qCDebug(dcOpenZWave) << "Remove node state changed to" << state << "for network" << homeId;
         }
         break;
+    case ControllerCommandRequestNodeNeighborUpdate:
+        if (state == ControllerStateCompleted || state == ControllerStateFailed || state == ControllerStateError) {
+            finishHeal(network, state == ControllerStateCompleted);
+        }
+        break;
+    case ControllerCommandAssignReturnRoute:
+    case ControllerCommandDeleteAllReturnRoutes:
+        // Part of healing a node
+        qCDebug(dcOpenZWave()) << "Return route update state changed to" << state << "for network" << homeId;
+        break;
 
     default:
         // Hack: sometimes we call add or remove, but we get other commands in return.
@@ -970,16 +2234,30 @@ void OpenZWaveBackend::onControllerCommand(quint32 homeId, ControllerCommand com
         // Not sure if that's a bug ni OZW, or if there's some fancy Z-Wave specced mechanism to do this stuff.
         // In any case, once a Completed comes in, anything previously isn't valid any more. so let's reset stuff
         if (state == ControllerStateCompleted) {
-            emit waitingForNodeAdditionChanged(m_homeIds.key(homeId), false);
-            emit waitingForNodeRemovalChanged(m_homeIds.key(homeId), false);
+            emit waitingForNodeAdditionChanged(network->networkUuid, false);
+            emit waitingForNodeRemovalChanged(network->networkUuid, false);
         }
         qCWarning(dcOpenZWave()) << "Unhandled controller command"  << command << state;
     }
 }
 
+void OpenZWaveBackend::onInteractiveTrafficChanged(bool active)
+{
+    if (!m_manager) {
+        return;
+    }
+    // OpenZWave polls on its own thread, the best we can do is to stretch the poll interval while
+    // interactive traffic is going on. Takes effect with the next poll.
+    if (active) {
+        m_manager->SetPollInterval(DeferredPollInterval, true);
+    } else {
+        m_manager->SetPollInterval(PollInterval, true);
+    }
+}
+
 void OpenZWaveBackend::initOZW(const QString &networkKey)
 {
-    QString userPath = NymeaSettings::storagePath() + "/openzwave/";
+    QString userPath = m_storagePath;
     QDir dir(userPath);
     if (!dir.exists()) {
         dir.mkpath(userPath);
@@ -993,9 +2271,14 @@ void OpenZWaveBackend::initOZW(const QString &networkKey)
     m_options->AddOptionBool("Logging", false);
     m_options->AddOptionBool("ConsoleOutput", false);
 
-    m_options->AddOptionInt("PollInterval", 5);
+    m_options->AddOptionInt("PollInterval", PollInterval);
     m_options->AddOptionBool("IntervalBetweenPolls", true);
     m_options->AddOptionBool("ValidateValueChanges", true);
+    // Required for the MsgComplete notifications used to confirm asynchronous writes. This makes OpenZWave
+    // report every message it sends, so on a busy network the callback sees up to one more notification per
+    // frame. The option can't be changed while the Manager runs, so the callback drops them instead while no
+    // asynchronous write is pending.
+    m_options->AddOptionBool("NotifyTransactions", true);
 
     // OZW wants the format: "0x01, 0x02, 0x04..."
     QString key = networkKey;
@@ -1004,6 +2287,7 @@ void OpenZWaveBackend::initOZW(const QString &networkKey)
     }
     key.prepend("0x");
     m_options->AddOptionString("NetworkKey", key.toStdString(), false);
+    m_networkKey = networkKey;
 
     m_options->Lock();
 
@@ -1017,4 +2301,5 @@ void OpenZWaveBackend::deinitOZW()
     m_manager = nullptr;
     m_options->Destroy();
     m_options = nullptr;
+    m_networkKey.clear();
 }
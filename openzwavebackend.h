@@ -28,10 +28,24 @@
 #include <hardware/zwave/zwavebackend.h>
 #include <hardware/zwave/zwavevalue.h>
 
+#include "openzwavenetwork.h"
+#include "openzwavenotificationqueue.h"
+#include "openzwavevaluecoalescer.h"
+#include "openzwavevaluesreply.h"
+#include "openzwavetrafficscheduler.h"
+#include "openzwavetrace.h"
+#include "openzwaveeventring.h"
+
 #include <Manager.h>
 
 #include <QObject>
 #include <QHash>
+#include <QMutex>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <QTime>
+
+#include <atomic>
 
 class OpenZWaveBackend : public ZWaveBackend
 {
@@ -106,6 +120,16 @@ public:
     };
     Q_ENUM(UserAlertNotification)
 
+    struct StartupTimes
+    {
+        quint32 count = 0;
+        qint64 last = 0;
+        qint64 max = 0;
+        qint64 total = 0;
+
+        qint64 average() const { return count > 0 ? total / count : 0; }
+    };
+
     explicit OpenZWaveBackend(QObject *parent = nullptr);
     ~OpenZWaveBackend();
 
@@ -113,6 +137,14 @@ public:
     bool startNetwork(const QUuid &networkUuid, const QString &serialPort, const QString &networkKey = QString()) override;
     bool stopNetwork(const QUuid &networkUuid) override;
 
+    // Cycles only the driver of the network, keeping the Manager and the known nodes and values.
+    // Meant for stick reconnects and USB resets.
+    bool restartNetwork(const QUuid &networkUuid);
+
+    // Time from adding the driver until it is ready, with the Manager created for it (cold) or already running (warm)
+    StartupTimes coldStartTimes() const;
+    StartupTimes warmStartTimes() const;
+
     quint32 homeId(const QUuid &networkUuid) override;
     quint8 controllerNodeId(const QUuid &networkUuid) override;
     bool isPrimaryController(const QUuid &networkUuid) override;
@@ -147,12 +179,98 @@ public:
     bool nodeIsSecureDevice(const QUuid &networkUuid, quint8 nodeId) override;
     bool nodeIsBeamingDevice(const QUuid &networkUuid, quint8 nodeId) override;
 
+    // Writes to sleeping nodes are held back until the node wakes up, see pendingWrites()
     bool setValue(const QUuid &networkUuid, quint8 nodeId, const ZWaveValue &value) override;
 
+    // Writes a batch of (node id, value) pairs, grouped per node in the order the nodes first appear. Of multiple
+    // writes to the same value of a node only the last one is executed. The returned reply is an
+    // OpenZWaveValuesReply with a result per written value.
+    ZWaveReply *setValues(const QUuid &networkUuid, const QList<QPair<quint8, ZWaveValue> > &values);
+
+    // Finishes once the device confirmed the value (ValueChanged or ValueRefreshed) or OpenZWave completed the
+    // message of the write (MsgComplete), and fails if the node times out. Round trip latencies are recorded per node.
+    ZWaveReply *setValueAsync(const QUuid &networkUuid, quint8 nodeId, const ZWaveValue &value);
+    OpenZWaveWriteTracker::Latency writeLatency(const QUuid &networkUuid, quint8 nodeId) const;
+
+    // Writes waiting for the node to wake up, in the order they will be sent
+    QList<ZWaveValue> pendingWrites(const QUuid &networkUuid, quint8 nodeId) const;
+    OpenZWaveWakeUpQueue::Statistics wakeUpQueueStatistics(const QUuid &networkUuid) const;
+
+    // Queued with refresh priority, behind interactive commands
+    bool refreshValue(const QUuid &networkUuid, quint8 nodeId, quint64 valueId);
+
+    OpenZWaveTrafficScheduler *trafficScheduler();
+
+    // Poll intensities are adapted per value, this tells how much poll traffic that saves
+    OpenZWavePollingEngine::Statistics pollingStatistics(const QUuid &networkUuid) const;
+
+    // Answered from the shadow copy, doesn't touch OpenZWave. Available from the snapshot before the network is up.
+    ZWaveValue value(const QUuid &networkUuid, quint8 nodeId, quint64 valueId) const;
+    OpenZWaveValueMetadata valueMetadata(const QUuid &networkUuid, quint64 valueId) const;
+
+    OpenZWaveNotificationQueue::Statistics notificationQueueStatistics() const;
+
+    // Records every dispatched notification to a binary trace file, which can be replayed offline with tests/replay
+    bool startTrace(const QString &fileName);
+    void stopTrace();
+    bool isTracing() const;
+
+    // RF and round trip statistics of all nodes are collected periodically, kept in a short history per node
+    // and written to openzwave/nodestatistics.txt in the storage path. An interval of 0 disables collecting.
+    OpenZWaveNodeStatistics::Sample nodeStatistics(const QUuid &networkUuid, quint8 nodeId) const;
+    QList<OpenZWaveNodeStatistics::Sample> nodeStatisticsHistory(const QUuid &networkUuid, quint8 nodeId) const;
+    void setNodeStatisticsInterval(int msecs);
+
+    // The driver statistics of each controller are sampled every minute. driverDegradedChanged() is emitted when
+    // retransmission, drop, timeout or framing error rates cross the thresholds, and again when they recover.
+    OpenZWaveDriverMonitor::Rates driverRates(const QUuid &networkUuid) const;
+    OpenZWaveDriverMonitor::Counters driverCounters(const QUuid &networkUuid) const;
+    void setDriverThresholds(const QUuid &networkUuid, const OpenZWaveDriverMonitor::Thresholds &thresholds);
+
+    // Nodes are healed one at a time per network within the quiet hours (02:00 - 05:00 by default), each at most
+    // about once a day. Heals are maintenance traffic and yield to interactive commands. Invalid times disable healing.
+    void setHealQuietHours(const QTime &start, const QTime &end);
+    // Average request round trip time of a node from before and after its last heal
+    OpenZWaveHealScheduler::Result healResult(const QUuid &networkUuid, quint8 nodeId) const;
+
+    // The last notifications, writes and controller command states are always kept in a binary event ring.
+    // It is dumped to openzwave/eventtrace-fault.bin in the storage path when a driver fails or degrades.
+    bool dumpEventTrace(const QString &fileName) const;
+
+    // Notification counters and dispatch latencies of a network. Notifications without a known network,
+    // e.g. before the driver is ready, are accounted to the null uuid.
+    OpenZWaveDispatchStatistics dispatchStatistics(const QUuid &networkUuid) const;
+    void resetDispatchStatistics();
+    // Periodically logs the dispatch statistics of all networks, 0 disables it
+    void setDispatchStatisticsDumpInterval(int msecs);
+
+    // Optional coalescing of value changes, disabled unless a window is configured
+    OpenZWaveValueCoalescer *valueCoalescer();
+
+    // Number of ValueRefreshed notifications which didn't change the value and have not been emitted as valueChanged
+    quint64 unchangedRefreshCount() const;
+
 signals:
+    void valueRefreshed(const QUuid &networkUuid, quint8 nodeId, quint64 valueId);
+    void driverDegradedChanged(const QUuid &networkUuid, bool degraded);
+
+private:
+    // Measures single steps of the notification and value handling, see tests/benchmarks
+    friend class BenchmarkOpenZWaveBackend;
+    // Replays into a temporary storage path, see tests/replay
+    friend class OpenZWaveTraceReplay;
+
+    void drainNotifications();
+    void dumpDispatchStatistics();
 
-private slots:
     void onDriverReady(quint32 homeId);
+    QUuid takePendingNetworkSetup(const QString &serialPort);
+    bool addDriver(OpenZWaveNetwork *network);
+    // Drops the setup from the pending ones and adds the next deferred driver, if any
+    void finishNetworkSetup(const QUuid &networkUuid);
+    // Forgets everything known about the node(s) and emits nodeRemoved
+    void dropNode(OpenZWaveNetwork *network, quint8 nodeId);
+    void dropAllNodes(OpenZWaveNetwork *network);
 #if OZW_16
     void onDriverFailed(const QString &serialPort);
 #else
@@ -165,6 +283,7 @@ private slots:
     void onNodeRemoved(quint32 homeId, quint8 nodeId);
     void onValueAdded(quint32 homeId, quint8 nodeId, quint64 id, ZWaveValue::Genre genre, ZWaveValue::CommandClass commandClass, quint8 instance, quint16 index, ZWaveValue::Type type);
     void onValueChanged(quint32 homeId, quint8 nodeId, quint64 id, ZWaveValue::Genre genre, ZWaveValue::CommandClass commandClass, quint8 instance, quint16 index, ZWaveValue::Type type);
+    void onValueRefreshed(quint32 homeId, quint8 nodeId, quint64 id, ZWaveValue::Genre genre, ZWaveValue::CommandClass commandClass, quint8 instance, quint16 index, ZWaveValue::Type type);
     void onValueRemoved(quint32 homeId, quint8 nodeId, quint64 id);
     void onNodeProtocolInfoReceived(quint32 homeId, quint8 nodeId);
     void onEssentialNodeQueriesComplete(quint32 homeId);
@@ -173,26 +292,144 @@ private slots:
     void onAllNodesQueried(quint32 homeId);
     void onZWaveNotification(quint32 homeId, quint8 nodeId, OpenZWaveBackend::NotificationCode code);
     void onControllerCommand(quint32 homeId, OpenZWaveBackend::ControllerCommand command, OpenZWaveBackend::ControllerState state);
+    void onInteractiveTrafficChanged(bool active);
 
-private:
     void initOZW(const QString &networkKey);
     void deinitOZW();
 
     static void ozwCallback(const OpenZWave::Notification *notification, void *context);
+    // The queue has a single producer, so this is only ever called on the OpenZWave notification thread
+    void enqueueNotification(OpenZWaveNotificationRecord record);
+
+    typedef void (OpenZWaveBackend::*NotificationHandler)(const OpenZWaveNotificationRecord &record);
+    class NotificationDispatchTable;
+    void processNotification(const OpenZWaveNotificationRecord &record);
+#ifdef OZW_16
+    // Called on the OpenZWave thread, returns the index to put into the DriverFailed record
+    quint64 parkFailedSerialPort(const QString &serialPort);
+#endif
+    template <void (OpenZWaveBackend::*handler)(quint32)>
+    void dispatchNetworkNotification(const OpenZWaveNotificationRecord &record);
+    template <void (OpenZWaveBackend::*handler)(quint32, quint8)>
+    void dispatchNodeNotification(const OpenZWaveNotificationRecord &record);
+    void dispatchValueAdded(const OpenZWaveNotificationRecord &record);
+    void dispatchValueChanged(const OpenZWaveNotificationRecord &record);
+    void dispatchValueRefreshed(const OpenZWaveNotificationRecord &record);
+    void dispatchValueRemoved(const OpenZWaveNotificationRecord &record);
+    void dispatchDriverFailed(const OpenZWaveNotificationRecord &record);
+    void dispatchZWaveNotification(const OpenZWaveNotificationRecord &record);
+    void dispatchControllerCommand(const OpenZWaveNotificationRecord &record);
+    void dispatchGroup(const OpenZWaveNotificationRecord &record);
+    void dispatchNodeEvent(const OpenZWaveNotificationRecord &record);
+#ifdef OZW_16
+    void dispatchUserAlert(const OpenZWaveNotificationRecord &record);
+#endif
 
-    ZWaveValue readValue(quint32 homeId, quint8 nodeId, quint64 id, ZWaveValue::Genre genre, ZWaveValue::CommandClass commandClassId, quint8 instance, quint16 index, ZWaveValue::Type type);
-    void updateNodeLinkQuality(quint32 homeId, quint8 nodeId);
+    // Cached node properties, filled on demand if not available yet
+    const OpenZWaveNodeInfo *nodeInfo(const QUuid &networkUuid, quint8 nodeId);
+    void fillNodeInfo(OpenZWaveNetwork *network, quint8 nodeId);
+
+    bool writeValue(OpenZWaveNetwork *network, const ZWaveValue &value);
+    bool sendValue(const OpenZWave::ValueID &valueId, const ZWaveValue &value);
+    // Battery devices which are neither listening nor awake right now
+    bool isNodeSleeping(OpenZWaveNetwork *network, quint8 nodeId);
+    void flushPendingWrites(OpenZWaveNetwork *network, quint8 nodeId);
+    void finishPendingWrites(const QList<ZWaveReply*> &replies, ZWave::ZWaveError error);
+    void updateTrackedWrites();
+
+    ZWaveValue readValue(OpenZWaveNetwork *network, quint8 nodeId, quint64 id, ZWaveValue::Genre genre, ZWaveValue::CommandClass commandClassId, quint8 instance, quint16 index, ZWaveValue::Type type);
+    OpenZWaveValueMetadata &readValueMetadata(OpenZWaveNetwork *network, const OpenZWave::ValueID &valueId);
+    void readValueListItems(const OpenZWave::ValueID &valueId, OpenZWaveValueMetadata &metadata);
+    void readValueData(const OpenZWave::ValueID &valueId, OpenZWaveValueMetadata &metadata, ZWaveValue &value);
+    // Updates the shadow copy and returns it, changed tells whether the value differs from the previous one
+    const ZWaveValue &updateValue(OpenZWaveNetwork *network, quint8 nodeId, quint64 id, ZWaveValue::Genre genre, ZWaveValue::CommandClass commandClass, quint8 instance, quint16 index, ZWaveValue::Type type, bool *changed = nullptr);
+    void updateNodeLinkQuality(OpenZWaveNetwork *network, quint8 nodeId);
+    void collectNodeStatistics();
+    void sampleDriverStatistics();
+    void scheduleHeals();
+    void finishHeal(OpenZWaveNetwork *network, bool success);
+    bool isHealQuietTime() const;
+    void recordEvent(OpenZWaveEventRing::EventType type, quint32 homeId, quint8 nodeId = 0, quint64 valueId = 0, quint8 arg1 = 0, quint8 arg2 = 0);
+    void dumpEventTraceOnFault();
+    void writeNodeStatistics();
+    void setPollIntensity(OpenZWaveNetwork *network, quint64 valueId, quint8 intensity);
+
+    // Nodes and values of the last run are presented right away from a snapshot and reconciled
+    // once OpenZWave has queried all nodes
+    QString snapshotFileName(const QUuid &networkUuid) const;
+    void loadSnapshot(OpenZWaveNetwork *network);
+    void saveSnapshot(OpenZWaveNetwork *network);
+    void discardSnapshot(OpenZWaveNetwork *network);
+
+    // Returns the network only once its driver is ready
+    OpenZWaveNetwork *startedNetwork(const QUuid &networkUuid) const;
+
+    // The Manager is kept running for a while after the last network has been stopped, so a
+    // reconnecting stick doesn't have to wait for it to load the device database again
+    static const int ManagerIdleTimeout = 60000;
+
+    static const int NodeStatisticsInterval = 300000;
+    static const int DriverStatisticsInterval = 60000;
+    static const int HealCheckInterval = 60000;
+    // Time between the start of two heals in the same network
+    static const int HealStagger = 300000;
+
+    // Don't overwrite the dump of a fault with the ones of its follow-up faults
+    static const int FaultDumpInterval = 600000;
+
+    static const int PollInterval = 5;
+    static const int DeferredPollInterval = 5000;
 
     OpenZWave::Options *m_options = nullptr;
     OpenZWave::Manager *m_manager = nullptr;
-
-    QHash<QUuid, QString> m_serialPorts;
-    QHash<QUuid, quint32> m_homeIds;
+    // The network key the Manager has been created with
+    QString m_networkKey;
+
+    OpenZWaveNotificationQueue m_notificationQueue;
+#ifdef OZW_16
+    // Serial ports of failed drivers until their DriverFailed record is dispatched
+    QMutex m_failedSerialPortsMutex;
+    QHash<quint64, QString> m_failedSerialPorts;
+    quint64 m_failedSerialPortIndex = 0;
+#endif
+    OpenZWaveStringPool m_stringPool;
+    OpenZWaveValueCoalescer m_valueCoalescer;
+    OpenZWaveTrafficScheduler m_trafficScheduler;
+    OpenZWaveTrace m_trace;
+    OpenZWaveEventRing m_eventRing;
+    qint64 m_lastFaultDump = -1;
+    OpenZWaveDispatchStatistics m_dispatchStatistics;
+    QTimer m_dispatchStatisticsDumpTimer;
+    QTimer m_nodeStatisticsTimer;
+    QTimer m_driverStatisticsTimer;
+    QTimer m_healTimer;
+    QTime m_healQuietStart = QTime(2, 0);
+    QTime m_healQuietEnd = QTime(5, 0);
+    quint64 m_unchangedRefreshes = 0;
+
+    // Monotonic time base for all timestamps kept by the backend
+    QElapsedTimer m_clock;
+    // OpenZWave user files, snapshots, statistics and fault dumps. The tools in tests/ use a temporary directory.
+    QString m_storagePath;
+
+    QTimer m_managerIdleTimer;
+    StartupTimes m_coldStartTimes;
+    StartupTimes m_warmStartTimes;
+
+    QHash<QUuid, OpenZWaveNetwork*> m_networks;
+    QHash<quint32, OpenZWaveNetwork*> m_networksByHomeId;
 
     QList<QUuid> m_pendingNetworkSetups;
+#ifndef OZW_16
+    // Networks whose driver is added once the pending setup finished
+    QList<QUuid> m_deferredNetworkSetups;
+#endif
 
     QHash<quint32, ZWaveReply*> m_pendingControllerCommands;
 
+    // Number of asynchronous writes waiting for confirmation, read by the OpenZWave callback
+    std::atomic<int> m_trackedWrites{0};
+
 #ifndef OZW_16
     ControllerCommand m_controllerCommand = ControllerCommandNone;
 #endif
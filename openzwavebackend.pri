@@ -0,0 +1,40 @@
+INCLUDEPATH += $$PWD
+
+SOURCES += \
+    $$PWD/openzwavebackend.cpp \
+    $$PWD/openzwavedispatchstatistics.cpp \
+    $$PWD/openzwavedrivermonitor.cpp \
+    $$PWD/openzwaveeventring.cpp \
+    $$PWD/openzwavehealscheduler.cpp \
+    $$PWD/openzwavelinkqualitysampler.cpp \
+    $$PWD/openzwavenodestatistics.cpp \
+    $$PWD/openzwavenotificationqueue.cpp \
+    $$PWD/openzwavepollingengine.cpp \
+    $$PWD/openzwavesnapshot.cpp \
+    $$PWD/openzwavetrace.cpp \
+    $$PWD/openzwavetrafficscheduler.cpp \
+    $$PWD/openzwavevaluecoalescer.cpp \
+    $$PWD/openzwavevaluemetadata.cpp \
+    $$PWD/openzwavevaluesreply.cpp \
+    $$PWD/openzwavewakeupqueue.cpp \
+    $$PWD/openzwavewritetracker.cpp
+
+HEADERS += \
+    $$PWD/openzwavebackend.h \
+    $$PWD/openzwavedispatchstatistics.h \
+    $$PWD/openzwavedrivermonitor.h \
+    $$PWD/openzwaveeventring.h \
+    $$PWD/openzwavehealscheduler.h \
+    $$PWD/openzwavelinkqualitysampler.h \
+    $$PWD/openzwavenetwork.h \
+    $$PWD/openzwavenodestatistics.h \
+    $$PWD/openzwavenotificationqueue.h \
+    $$PWD/openzwavepollingengine.h \
+    $$PWD/openzwavesnapshot.h \
+    $$PWD/openzwavetrace.h \
+    $$PWD/openzwavetrafficscheduler.h \
+    $$PWD/openzwavevaluecoalescer.h \
+    $$PWD/openzwavevaluemetadata.h \
+    $$PWD/openzwavevaluesreply.h \
+    $$PWD/openzwavewakeupqueue.h \
+    $$PWD/openzwavewritetracker.h
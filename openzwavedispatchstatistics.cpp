@@ -0,0 +1,93 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+*
+* Copyright (C) 2013 - 2024, nymea GmbH
+* Copyright (C) 2024 - 2025, chargebyte austria GmbH
+*
+* This file is part of nymea-zwave-plugin-openzwave.
+*
+* nymea-zwave-plugin-openzwave is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* nymea-zwave-plugin-openzwave is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with nymea-zwave-plugin-openzwave. If not, see <https://www.gnu.org/licenses/>.
+*
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "openzwavedispatchstatistics.h"
+
+#include <QStringList>
+
+void OpenZWaveDispatchStatistics::Histogram::add(quint64 usecs)
+{
+    int index = 0;
+    while (index < Buckets - 1 && (usecs >> (index + 1)) > 0) {
+        index++;
+    }
+    m_buckets[index]++;
+    m_count++;
+    m_total += usecs;
+    m_max = qMax(m_max, usecs);
+}
+
+quint64 OpenZWaveDispatchStatistics::Histogram::percentile(int percent) const
+{
+    quint64 threshold = (m_count * percent + 99) / 100;
+    quint64 sum = 0;
+    for (int i = 0; i < Buckets; i++) {
+        sum += m_buckets[i];
+        if (sum >= threshold && sum > 0) {
+            return i < Buckets - 1 ? (Q_UINT64_C(1) << (i + 1)) : m_max;
+        }
+    }
+    return 0;
+}
+
+QString OpenZWaveDispatchStatistics::Histogram::toString() const
+{
+    return QString("count %1, avg %2 us, p50 < %3 us, p99 < %4 us, max %5 us")
+            .arg(m_count).arg(average()).arg(percentile(50)).arg(percentile(99)).arg(m_max);
+}
+
+void OpenZWaveDispatchStatistics::record(quint8 type, quint8 code, bool hasCode, quint64 queueDelay, quint64 handlerTime)
+{
+    if (type < Types) {
+        m_types[type]++;
+    }
+    if (hasCode && code < Codes) {
+        m_codes[code]++;
+    }
+    m_queueDelay.add(queueDelay);
+    m_handlerTime.add(handlerTime);
+}
+
+void OpenZWaveDispatchStatistics::reset()
+{
+    *this = OpenZWaveDispatchStatistics();
+}
+
+QString OpenZWaveDispatchStatistics::toString() const
+{
+    QStringList types;
+    for (int i = 0; i < Types; i++) {
+        if (m_types[i] > 0) {
+            types.append(QString("%1: %2").arg(i).arg(m_types[i]));
+        }
+    }
+    QStringList codes;
+    for (int i = 0; i < Codes; i++) {
+        if (m_codes[i] > 0) {
+            codes.append(QString("%1: %2").arg(i).arg(m_codes[i]));
+        }
+    }
+    return QString("types {%1}, codes {%2}, queue delay {%3}, handler time {%4}")
+            .arg(types.join(", ")).arg(codes.join(", ")).arg(m_queueDelay.toString()).arg(m_handlerTime.toString());
+}
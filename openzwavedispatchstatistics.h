@@ -0,0 +1,80 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+*
+* Copyright (C) 2013 - 2024, nymea GmbH
+* Copyright (C) 2024 - 2025, chargebyte austria GmbH
+*
+* This file is part of nymea-zwave-plugin-openzwave.
+*
+* nymea-zwave-plugin-openzwave is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* nymea-zwave-plugin-openzwave is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with nymea-zwave-plugin-openzwave. If not, see <https://www.gnu.org/licenses/>.
+*
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef OPENZWAVEDISPATCHSTATISTICS_H
+#define OPENZWAVEDISPATCHSTATISTICS_H
+
+#include <QString>
+
+// Counters per notification type and code, plus histograms of how long notifications waited in the queue
+// (OpenZWave callback to Qt thread) and how long handling them took, including everything connected
+// directly to the emitted signals.
+class OpenZWaveDispatchStatistics
+{
+public:
+    // Bucket i counts durations of [2^i, 2^(i+1)) µs, the first one everything below 2 µs and
+    // the last one everything from 2^(Buckets-1) µs (about 8 s) on.
+    class Histogram
+    {
+    public:
+        static const int Buckets = 24;
+
+        void add(quint64 usecs);
+        quint64 count() const { return m_count; }
+        quint64 max() const { return m_max; }
+        quint64 average() const { return m_count > 0 ? m_total / m_count : 0; }
+        quint64 bucket(int index) const { return m_buckets[index]; }
+        // Upper bound of the bucket the given percentile (0 - 100) falls into
+        quint64 percentile(int percent) const;
+
+        QString toString() const;
+
+    private:
+        quint64 m_buckets[Buckets] = {};
+        quint64 m_count = 0;
+        quint64 m_total = 0;
+        quint64 m_max = 0;
+    };
+
+    static const int Types = 32;
+    static const int Codes = 8;
+
+    void record(quint8 type, quint8 code, bool hasCode, quint64 queueDelay, quint64 handlerTime);
+    void reset();
+
+    quint64 typeCount(quint8 type) const { return type < Types ? m_types[type] : 0; }
+    quint64 codeCount(quint8 code) const { return code < Codes ? m_codes[code] : 0; }
+    const Histogram &queueDelay() const { return m_queueDelay; }
+    const Histogram &handlerTime() const { return m_handlerTime; }
+
+    QString toString() const;
+
+private:
+    quint64 m_types[Types] = {};
+    quint64 m_codes[Codes] = {};
+    Histogram m_queueDelay;
+    Histogram m_handlerTime;
+};
+
+#endif // OPENZWAVEDISPATCHSTATISTICS_H
@@ -0,0 +1,128 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+*
+* Copyright (C) 2013 - 2024, nymea GmbH
+* Copyright (C) 2024 - 2025, chargebyte austria GmbH
+*
+* This file is part of nymea-zwave-plugin-openzwave.
+*
+* nymea-zwave-plugin-openzwave is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* nymea-zwave-plugin-openzwave is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with nymea-zwave-plugin-openzwave. If not, see <https://www.gnu.org/licenses/>.
+*
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "openzwavedrivermonitor.h"
+
+OpenZWaveDriverMonitor::Counters OpenZWaveDriverMonitor::fromDriverData(const OpenZWave::Driver::DriverData &driverData)
+{
+    Counters counters;
+    counters.sof = driverData.m_SOFCnt;
+    counters.ackWaiting = driverData.m_ACKWaiting;
+    counters.readAborts = driverData.m_readAborts;
+    counters.badChecksum = driverData.m_badChecksum;
+    counters.reads = driverData.m_readCnt;
+    counters.writes = driverData.m_writeCnt;
+    counters.can = driverData.m_CANCnt;
+    counters.nak = driverData.m_NAKCnt;
+    counters.ack = driverData.m_ACKCnt;
+    counters.oof = driverData.m_OOFCnt;
+    counters.dropped = driverData.m_dropped;
+    counters.retries = driverData.m_retries;
+    counters.noAck = driverData.m_noack;
+    counters.netBusy = driverData.m_netbusy;
+    return counters;
+}
+
+bool OpenZWaveDriverMonitor::update(const Counters &counters, qint64 now)
+{
+    Counters previous = m_counters;
+    qint64 previousTimestamp = m_timestamp;
+    m_counters = counters;
+    m_timestamp = now;
+
+    // The counters start over when the driver is restarted, that sample is only a new baseline
+    if (previousTimestamp < 0 || now <= previousTimestamp || counters.writes < previous.writes || counters.reads < previous.reads) {
+        return false;
+    }
+
+    Rates rates;
+    rates.interval = now - previousTimestamp;
+    rates.writes = counters.writes - previous.writes;
+    if (rates.writes > 0) {
+        rates.retryRatio = static_cast<double>(counters.retries - previous.retries) / rates.writes;
+        rates.dropRatio = static_cast<double>(counters.dropped - previous.dropped) / rates.writes;
+        rates.timeoutRatio = static_cast<double>(counters.noAck - previous.noAck) / rates.writes;
+        rates.ackWaitingRatio = static_cast<double>(counters.ackWaiting - previous.ackWaiting) / rates.writes;
+    }
+    quint32 frameErrors = (counters.can - previous.can)
+            + (counters.nak - previous.nak)
+            + (counters.oof - previous.oof)
+            + (counters.badChecksum - previous.badChecksum)
+            + (counters.readAborts - previous.readAborts);
+    rates.frameErrorsPerMinute = frameErrors * 60000.0 / rates.interval;
+    m_rates = rates;
+
+    bool degraded = exceedsThresholds(rates);
+    if (degraded == m_degraded) {
+        return false;
+    }
+    m_degraded = degraded;
+    return true;
+}
+
+void OpenZWaveDriverMonitor::reset()
+{
+    m_counters = Counters();
+    m_timestamp = -1;
+    m_rates = Rates();
+    m_degraded = false;
+}
+
+bool OpenZWaveDriverMonitor::isDegraded() const
+{
+    return m_degraded;
+}
+
+OpenZWaveDriverMonitor::Counters OpenZWaveDriverMonitor::counters() const
+{
+    return m_counters;
+}
+
+OpenZWaveDriverMonitor::Rates OpenZWaveDriverMonitor::rates() const
+{
+    return m_rates;
+}
+
+OpenZWaveDriverMonitor::Thresholds OpenZWaveDriverMonitor::thresholds() const
+{
+    return m_thresholds;
+}
+
+void OpenZWaveDriverMonitor::setThresholds(const Thresholds &thresholds)
+{
+    m_thresholds = thresholds;
+}
+
+bool OpenZWaveDriverMonitor::exceedsThresholds(const Rates &rates) const
+{
+    if (rates.frameErrorsPerMinute > m_thresholds.frameErrorsPerMinute) {
+        return true;
+    }
+    if (rates.writes < m_thresholds.minWrites) {
+        return false;
+    }
+    return rates.retryRatio > m_thresholds.retryRatio
+            || rates.dropRatio > m_thresholds.dropRatio
+            || rates.timeoutRatio > m_thresholds.timeoutRatio;
+}
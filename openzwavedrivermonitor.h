@@ -0,0 +1,102 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+*
+* Copyright (C) 2013 - 2024, nymea GmbH
+* Copyright (C) 2024 - 2025, chargebyte austria GmbH
+*
+* This file is part of nymea-zwave-plugin-openzwave.
+*
+* nymea-zwave-plugin-openzwave is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* nymea-zwave-plugin-openzwave is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with nymea-zwave-plugin-openzwave. If not, see <https://www.gnu.org/licenses/>.
+*
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef OPENZWAVEDRIVERMONITOR_H
+#define OPENZWAVEDRIVERMONITOR_H
+
+#include <Manager.h>
+#include <Driver.h>
+
+#include <QtGlobal>
+
+// Turns the cumulative driver statistics of a controller into rates between two samples and tells when
+// retransmissions, drops or framing errors on the serial link cross the configured thresholds.
+class OpenZWaveDriverMonitor
+{
+public:
+    struct Counters
+    {
+        quint32 sof = 0;
+        quint32 ackWaiting = 0;
+        quint32 readAborts = 0;
+        quint32 badChecksum = 0;
+        quint32 reads = 0;
+        quint32 writes = 0;
+        quint32 can = 0;
+        quint32 nak = 0;
+        quint32 ack = 0;
+        quint32 oof = 0;
+        quint32 dropped = 0;
+        quint32 retries = 0;
+        quint32 noAck = 0;
+        quint32 netBusy = 0;
+    };
+
+    struct Rates
+    {
+        qint64 interval = 0;
+        quint32 writes = 0;
+        double retryRatio = 0;
+        double dropRatio = 0;
+        // Messages the node never acknowledged
+        double timeoutRatio = 0;
+        // Unsolicited messages which arrived while waiting for an ACK of the controller. Informational only.
+        double ackWaitingRatio = 0;
+        double frameErrorsPerMinute = 0;
+    };
+
+    struct Thresholds
+    {
+        double retryRatio = 0.1;
+        double dropRatio = 0.02;
+        double timeoutRatio = 0.05;
+        double frameErrorsPerMinute = 10;
+        // Ratios over fewer writes than this are too noisy to alarm on
+        quint32 minWrites = 20;
+    };
+
+    static Counters fromDriverData(const OpenZWave::Driver::DriverData &driverData);
+
+    // Returns true if the degraded state changed with this sample
+    bool update(const Counters &counters, qint64 now);
+    void reset();
+
+    bool isDegraded() const;
+    Counters counters() const;
+    Rates rates() const;
+
+    Thresholds thresholds() const;
+    void setThresholds(const Thresholds &thresholds);
+
+private:
+    bool exceedsThresholds(const Rates &rates) const;
+
+    Counters m_counters;
+    qint64 m_timestamp = -1;
+    Rates m_rates;
+    Thresholds m_thresholds;
+    bool m_degraded = false;
+};
+
+#endif // OPENZWAVEDRIVERMONITOR_H
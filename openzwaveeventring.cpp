@@ -0,0 +1,68 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+*
+* Copyright (C) 2013 - 2024, nymea GmbH
+* Copyright (C) 2024 - 2025, chargebyte austria GmbH
+*
+* This file is part of nymea-zwave-plugin-openzwave.
+*
+* nymea-zwave-plugin-openzwave is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* nymea-zwave-plugin-openzwave is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with nymea-zwave-plugin-openzwave. If not, see <https://www.gnu.org/licenses/>.
+*
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "openzwaveeventring.h"
+
+#include <QSaveFile>
+
+#include <cstring>
+
+namespace {
+
+struct Header
+{
+    char magic[4];
+    quint32 version;
+    quint32 recordSize;
+    quint32 count;
+};
+
+}
+
+quint64 OpenZWaveEventRing::count() const
+{
+    return m_next;
+}
+
+bool OpenZWaveEventRing::dump(const QString &fileName) const
+{
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    quint32 count = qMin<quint64>(m_next, Capacity);
+    Header header;
+    memcpy(header.magic, "OZWE", sizeof(header.magic));
+    header.version = Version;
+    header.recordSize = sizeof(Event);
+    header.count = count;
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    // Once wrapped, the oldest record is the one to be overwritten next
+    quint32 first = (m_next - count) & (Capacity - 1);
+    quint32 tail = qMin(count, Capacity - first);
+    file.write(reinterpret_cast<const char*>(m_events + first), tail * sizeof(Event));
+    file.write(reinterpret_cast<const char*>(m_events), (count - tail) * sizeof(Event));
+    return file.commit();
+}
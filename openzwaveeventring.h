@@ -0,0 +1,78 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+*
+* Copyright (C) 2013 - 2024, nymea GmbH
+* Copyright (C) 2024 - 2025, chargebyte austria GmbH
+*
+* This file is part of nymea-zwave-plugin-openzwave.
+*
+* nymea-zwave-plugin-openzwave is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* nymea-zwave-plugin-openzwave is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with nymea-zwave-plugin-openzwave. If not, see <https://www.gnu.org/licenses/>.
+*
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef OPENZWAVEEVENTRING_H
+#define OPENZWAVEEVENTRING_H
+
+#include <QString>
+
+// Always on, in memory trace of the last backend events as fixed size binary records. Recording is a
+// plain copy into a ring, the oldest records are overwritten. Only used from the Qt thread.
+class OpenZWaveEventRing
+{
+public:
+    enum EventType {
+        EventNotification = 1, // arg1: notification type, arg2: notification code
+        EventWrite, // arg1: 1 if OpenZWave accepted the write
+        EventWriteQueued, // Held back until the sleeping node wakes up
+        EventControllerCommand, // arg1: command, arg2: state
+        EventDriverFailed,
+        EventDriverDegraded // arg1: 1 if degraded, 0 if recovered
+    };
+
+    struct Event
+    {
+        quint64 timestamp; // Microseconds on the backend clock
+        quint64 valueId;
+        quint32 homeId;
+        quint8 type;
+        quint8 nodeId;
+        quint8 arg1;
+        quint8 arg2;
+    };
+
+    static const quint32 Capacity = 8192;
+    static const quint32 Version = 1;
+
+    void record(quint64 timestamp, EventType type, quint32 homeId, quint8 nodeId = 0, quint64 valueId = 0, quint8 arg1 = 0, quint8 arg2 = 0) {
+        Event &event = m_events[m_next++ & (Capacity - 1)];
+        event.timestamp = timestamp;
+        event.valueId = valueId;
+        event.homeId = homeId;
+        event.type = type;
+        event.nodeId = nodeId;
+        event.arg1 = arg1;
+        event.arg2 = arg2;
+    }
+
+    quint64 count() const;
+    // Writes the recorded events, oldest first, with a short header
+    bool dump(const QString &fileName) const;
+
+private:
+    Event m_events[Capacity];
+    quint64 m_next = 0;
+};
+
+#endif // OPENZWAVEEVENTRING_H
@@ -0,0 +1,129 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+*
+* Copyright (C) 2013 - 2024, nymea GmbH
+* Copyright (C) 2024 - 2025, chargebyte austria GmbH
+*
+* This file is part of nymea-zwave-plugin-openzwave.
+*
+* nymea-zwave-plugin-openzwave is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* nymea-zwave-plugin-openzwave is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with nymea-zwave-plugin-openzwave. If not, see <https://www.gnu.org/licenses/>.
+*
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "openzwavehealscheduler.h"
+
+quint8 OpenZWaveHealScheduler::nextNode(const QList<quint8> &nodes, qint64 now) const
+{
+    quint8 next = 0;
+    qint64 nextStarted = 0;
+    foreach (quint8 nodeId, nodes) {
+        qint64 started = m_results.value(nodeId).started;
+        if (started >= 0 && now - started < MinimumAge) {
+            continue;
+        }
+        if (next == 0 || started < nextStarted) {
+            next = nodeId;
+            nextStarted = started;
+        }
+    }
+    return next;
+}
+
+void OpenZWaveHealScheduler::queue(quint8 nodeId)
+{
+    m_queuedNode = nodeId;
+}
+
+void OpenZWaveHealScheduler::cancel()
+{
+    m_queuedNode = 0;
+}
+
+void OpenZWaveHealScheduler::start(quint8 nodeId, qint64 now, quint32 rtt)
+{
+    Result result;
+    result.started = now;
+    result.rttBefore = rtt;
+    m_results.insert(nodeId, result);
+    m_queuedNode = 0;
+    m_currentNode = nodeId;
+    m_lastStarted = now;
+}
+
+quint8 OpenZWaveHealScheduler::finish(qint64 now, bool success, quint32 sent)
+{
+    quint8 nodeId = m_currentNode;
+    if (nodeId == 0) {
+        return 0;
+    }
+    Result &result = m_results[nodeId];
+    result.finished = now;
+    result.success = success;
+    result.sentAtFinish = sent;
+    m_currentNode = 0;
+    return nodeId;
+}
+
+quint8 OpenZWaveHealScheduler::currentNode() const
+{
+    return m_currentNode;
+}
+
+bool OpenZWaveHealScheduler::isBusy() const
+{
+    return m_queuedNode != 0 || m_currentNode != 0;
+}
+
+qint64 OpenZWaveHealScheduler::lastStarted() const
+{
+    return m_lastStarted;
+}
+
+QList<quint8> OpenZWaveHealScheduler::pendingMeasurements(qint64 now) const
+{
+    QList<quint8> nodes;
+    for (QHash<quint8, Result>::const_iterator it = m_results.constBegin(); it != m_results.constEnd(); ++it) {
+        if (!it.value().measured && it.value().finished >= 0 && now - it.value().finished >= MeasurementDelay) {
+            nodes.append(it.key());
+        }
+    }
+    return nodes;
+}
+
+void OpenZWaveHealScheduler::measure(quint8 nodeId, quint32 rtt)
+{
+    QHash<quint8, Result>::iterator it = m_results.find(nodeId);
+    if (it == m_results.end()) {
+        return;
+    }
+    it.value().measured = true;
+    it.value().rttAfter = rtt;
+}
+
+OpenZWaveHealScheduler::Result OpenZWaveHealScheduler::result(quint8 nodeId) const
+{
+    return m_results.value(nodeId);
+}
+
+void OpenZWaveHealScheduler::removeNode(quint8 nodeId)
+{
+    m_results.remove(nodeId);
+    if (m_queuedNode == nodeId) {
+        m_queuedNode = 0;
+    }
+    if (m_currentNode == nodeId) {
+        m_currentNode = 0;
+    }
+}
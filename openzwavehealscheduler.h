@@ -0,0 +1,82 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+*
+* Copyright (C) 2013 - 2024, nymea GmbH
+* Copyright (C) 2024 - 2025, chargebyte austria GmbH
+*
+* This file is part of nymea-zwave-plugin-openzwave.
+*
+* nymea-zwave-plugin-openzwave is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* nymea-zwave-plugin-openzwave is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with nymea-zwave-plugin-openzwave. If not, see <https://www.gnu.org/licenses/>.
+*
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef OPENZWAVEHEALSCHEDULER_H
+#define OPENZWAVEHEALSCHEDULER_H
+
+#include <QHash>
+#include <QList>
+
+// Decides which node of a network to heal next, one at a time, and keeps the average request round trip
+// time of each node from before and after its last heal.
+class OpenZWaveHealScheduler
+{
+public:
+    struct Result
+    {
+        qint64 started = -1;
+        qint64 finished = -1;
+        bool success = false;
+        quint32 rttBefore = 0;
+        // Requests sent to the node until the heal finished, the measurement waits for newer ones
+        quint32 sentAtFinish = 0;
+        // Measured once the node has sent requests over the new routes
+        bool measured = false;
+        quint32 rttAfter = 0;
+    };
+
+    // Heal each node at most about once a day
+    static const qint64 MinimumAge = 20 * 60 * 60 * 1000LL;
+    // Without completion report (OpenZWave < 1.6) a heal is considered done after this
+    static const qint64 Timeout = 120000;
+    static const qint64 MeasurementDelay = 600000;
+
+    // The least recently healed of the given nodes, 0 if all of them have been healed recently
+    quint8 nextNode(const QList<quint8> &nodes, qint64 now) const;
+
+    // A heal is queued until the traffic scheduler lets it start, cancel() drops it if that didn't happen
+    void queue(quint8 nodeId);
+    void cancel();
+    void start(quint8 nodeId, qint64 now, quint32 rtt);
+    // Finishes the heal in progress and returns its node, 0 if there is none
+    quint8 finish(qint64 now, bool success, quint32 sent);
+    // The node being healed, 0 while none is running, also while one is only queued
+    quint8 currentNode() const;
+    bool isBusy() const;
+    qint64 lastStarted() const;
+
+    QList<quint8> pendingMeasurements(qint64 now) const;
+    void measure(quint8 nodeId, quint32 rtt);
+
+    Result result(quint8 nodeId) const;
+    void removeNode(quint8 nodeId);
+
+private:
+    QHash<quint8, Result> m_results;
+    quint8 m_queuedNode = 0;
+    quint8 m_currentNode = 0;
+    qint64 m_lastStarted = -1;
+};
+
+#endif // OPENZWAVEHEALSCHEDULER_H
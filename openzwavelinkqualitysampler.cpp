@@ -0,0 +1,109 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+*
+* Copyright (C) 2013 - 2024, nymea GmbH
+* Copyright (C) 2024 - 2025, chargebyte austria GmbH
+*
+* This file is part of nymea-zwave-plugin-openzwave.
+*
+* nymea-zwave-plugin-openzwave is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* nymea-zwave-plugin-openzwave is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with nymea-zwave-plugin-openzwave. If not, see <https://www.gnu.org/licenses/>.
+*
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "openzwavelinkqualitysampler.h"
+
+#include <QByteArray>
+
+#include <cstdlib>
+
+bool OpenZWaveLinkQualitySampler::isDue(quint8 nodeId, qint64 now) const
+{
+    const Sample &sample = m_samples[nodeId];
+    return sample.timestamp < 0 || now - sample.timestamp >= m_interval;
+}
+
+bool OpenZWaveLinkQualitySampler::update(quint8 nodeId, qint64 now, quint8 linkQuality)
+{
+    Sample &sample = m_samples[nodeId];
+    sample.timestamp = now;
+    qint8 bucket = linkQuality / BucketSize;
+    if (bucket == sample.bucket) {
+        return false;
+    }
+    sample.bucket = bucket;
+    return true;
+}
+
+void OpenZWaveLinkQualitySampler::reset(quint8 nodeId)
+{
+    m_samples[nodeId] = Sample();
+}
+
+qint64 OpenZWaveLinkQualitySampler::interval() const
+{
+    return m_interval;
+}
+
+void OpenZWaveLinkQualitySampler::setInterval(qint64 interval)
+{
+    m_interval = interval;
+}
+
+quint8 OpenZWaveLinkQualitySampler::linkQuality(const OpenZWave::Node::NodeData &nodeData)
+{
+#ifdef OZW_16
+    const char *rssis[] = {
+        nodeData.m_rssi_1,
+        nodeData.m_rssi_2,
+        nodeData.m_rssi_3,
+        nodeData.m_rssi_4,
+        nodeData.m_rssi_5
+    };
+
+    int sum = 0;
+    int count = 0;
+    for (const char *rssi: rssis) {
+        int dbm;
+        if (parseRssi(rssi, &dbm)) {
+            sum += dbm;
+            count++;
+        }
+    }
+    int avg = count > 0 ? sum / count : -76;
+
+    return qMin(100, qMax(0, 2 * (avg + 100)));
+#else
+    return qMin(100, qMax(0, 2 * (nodeData.m_quality + 100)));
+#endif
+}
+
+bool OpenZWaveLinkQualitySampler::parseRssi(const char *rssi, int *dbm)
+{
+    if (qstrcmp(rssi, "MAX") == 0) {
+        *dbm = -50;
+        return true;
+    }
+    if (qstrcmp(rssi, "MIN") == 0) {
+        *dbm = -100;
+        return true;
+    }
+    char *end = nullptr;
+    long val = strtol(rssi, &end, 10);
+    if (end == rssi || *end != '\0') {
+        return false;
+    }
+    *dbm = static_cast<int>(val);
+    return true;
+}
@@ -0,0 +1,63 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+*
+* Copyright (C) 2013 - 2024, nymea GmbH
+* Copyright (C) 2024 - 2025, chargebyte austria GmbH
+*
+* This file is part of nymea-zwave-plugin-openzwave.
+*
+* nymea-zwave-plugin-openzwave is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* nymea-zwave-plugin-openzwave is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with nymea-zwave-plugin-openzwave. If not, see <https://www.gnu.org/licenses/>.
+*
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef OPENZWAVELINKQUALITYSAMPLER_H
+#define OPENZWAVELINKQUALITYSAMPLER_H
+
+#include <Manager.h>
+
+#include <QtGlobal>
+
+// Rate limits the node statistics lookups for the link quality and only reports
+// a new link quality when it moves to a different bucket.
+class OpenZWaveLinkQualitySampler
+{
+public:
+    static const qint64 DefaultInterval = 60000;
+    static const int BucketSize = 10;
+
+    bool isDue(quint8 nodeId, qint64 now) const;
+    // Returns true if the quality moved to a different bucket and should be reported
+    bool update(quint8 nodeId, qint64 now, quint8 linkQuality);
+    void reset(quint8 nodeId);
+
+    qint64 interval() const;
+    void setInterval(qint64 interval);
+
+    // Maps the RSSI values (or the quality on OZW < 1.6) to 0 - 100
+    static quint8 linkQuality(const OpenZWave::Node::NodeData &nodeData);
+
+private:
+    struct Sample {
+        qint64 timestamp = -1;
+        qint8 bucket = -1;
+    };
+
+    static bool parseRssi(const char *rssi, int *dbm);
+
+    Sample m_samples[256];
+    qint64 m_interval = DefaultInterval;
+};
+
+#endif // OPENZWAVELINKQUALITYSAMPLER_H
@@ -0,0 +1,124 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+*
+* Copyright (C) 2013 - 2024, nymea GmbH
+* Copyright (C) 2024 - 2025, chargebyte austria GmbH
+*
+* This file is part of nymea-zwave-plugin-openzwave.
+*
+* nymea-zwave-plugin-openzwave is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* nymea-zwave-plugin-openzwave is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with nymea-zwave-plugin-openzwave. If not, see <https://www.gnu.org/licenses/>.
+*
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef OPENZWAVENETWORK_H
+#define OPENZWAVENETWORK_H
+
+#include "openzwavevaluemetadata.h"
+#include "openzwavelinkqualitysampler.h"
+#include "openzwavewritetracker.h"
+#include "openzwavepollingengine.h"
+#include "openzwavewakeupqueue.h"
+#include "openzwavedispatchstatistics.h"
+#include "openzwavenodestatistics.h"
+#include "openzwavedrivermonitor.h"
+#include "openzwavehealscheduler.h"
+
+#include <hardware/zwave/zwavevalue.h>
+
+#include <QUuid>
+#include <QString>
+#include <QHash>
+#include <QSet>
+
+// Node properties as reported by OpenZWave, with the ids already parsed
+class OpenZWaveNodeInfo
+{
+public:
+    bool valid = false;
+
+    QString name;
+    QString manufacturerName;
+    QString productName;
+    quint16 manufacturerId = 0;
+    quint16 productId = 0;
+    quint16 productType = 0;
+    quint16 deviceType = 0;
+    quint8 basic = 0;
+    quint8 role = 0;
+    quint8 security = 0;
+    quint8 version = 0;
+    quint8 plusType = 0;
+    bool zwavePlus = false;
+    bool beaming = false;
+    bool secure = false;
+};
+
+// Per network state of the backend. Owned by OpenZWaveBackend and indexed by both, network uuid and home id.
+class OpenZWaveNetwork
+{
+public:
+    OpenZWaveNetwork(const QUuid &networkUuid, const QString &serialPort):
+        networkUuid(networkUuid),
+        serialPort(serialPort)
+    {
+    }
+
+    QUuid networkUuid;
+    QString serialPort;
+
+    // 0 until the driver is ready
+    quint32 homeId = 0;
+
+    // When the driver has been added, -1 once it is ready. And whether the Manager was already running at that time.
+    qint64 driverAdded = -1;
+    bool warmStart = false;
+
+    // Nodes OpenZWave reported as added, also those without any values
+    QSet<quint8> nodeIds;
+
+    // Shadow copy of all values, per node and value id
+    QHash<quint8, QHash<quint64, ZWaveValue> > values;
+    QHash<quint64, OpenZWaveValueMetadata> metadata;
+
+    // Nodes and values presented from the snapshot which OpenZWave didn't confirm yet
+    quint32 snapshotHomeId = 0;
+    QSet<quint8> snapshotNodes;
+    QSet<quint64> snapshotValues;
+
+    OpenZWaveLinkQualitySampler linkQualitySampler;
+    OpenZWaveWriteTracker writeTracker;
+    OpenZWavePollingEngine pollingEngine;
+    OpenZWaveWakeUpQueue wakeUpQueue;
+    OpenZWaveDispatchStatistics dispatchStatistics;
+    OpenZWaveNodeStatistics nodeStatistics;
+    OpenZWaveDriverMonitor driverMonitor;
+    OpenZWaveHealScheduler healScheduler;
+
+    static const int MaxNodes = 232;
+
+    // Returns nullptr for node ids out of the 1 - 232 range
+    OpenZWaveNodeInfo *nodeInfo(quint8 nodeId) {
+        return nodeId >= 1 && nodeId <= MaxNodes ? &nodes[nodeId - 1] : nullptr;
+    }
+    void invalidateNodeInfo(quint8 nodeId) {
+        if (nodeId >= 1 && nodeId <= MaxNodes) {
+            nodes[nodeId - 1] = OpenZWaveNodeInfo();
+        }
+    }
+
+    OpenZWaveNodeInfo nodes[MaxNodes];
+};
+
+#endif // OPENZWAVENETWORK_H
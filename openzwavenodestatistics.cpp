@@ -0,0 +1,90 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+*
+* Copyright (C) 2013 - 2024, nymea GmbH
+* Copyright (C) 2024 - 2025, chargebyte austria GmbH
+*
+* This file is part of nymea-zwave-plugin-openzwave.
+*
+* nymea-zwave-plugin-openzwave is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* nymea-zwave-plugin-openzwave is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with nymea-zwave-plugin-openzwave. If not, see <https://www.gnu.org/licenses/>.
+*
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "openzwavenodestatistics.h"
+#include "openzwavelinkqualitysampler.h"
+
+OpenZWaveNodeStatistics::Sample OpenZWaveNodeStatistics::sample(const OpenZWave::Node::NodeData &nodeData, qint64 now)
+{
+    Sample sample;
+    sample.timestamp = now;
+    sample.sent = nodeData.m_sentCnt;
+    sample.sentFailed = nodeData.m_sentFailed;
+    sample.retries = nodeData.m_retries;
+    sample.received = nodeData.m_receivedCnt;
+    sample.receivedDuplicates = nodeData.m_receivedDups;
+    sample.receivedUnsolicited = nodeData.m_receivedUnsolicited;
+    sample.lastRequestRtt = nodeData.m_lastRequestRTT;
+    sample.averageRequestRtt = nodeData.m_averageRequestRTT;
+    sample.lastResponseRtt = nodeData.m_lastResponseRTT;
+    sample.averageResponseRtt = nodeData.m_averageResponseRTT;
+    sample.linkQuality = OpenZWaveLinkQualitySampler::linkQuality(nodeData);
+#ifdef OZW_16
+    sample.hops = nodeData.m_hops;
+    sample.txTime = nodeData.m_txTime;
+#endif
+    return sample;
+}
+
+void OpenZWaveNodeStatistics::add(quint8 nodeId, const Sample &sample)
+{
+    History &history = m_history[nodeId];
+    history.samples[history.next] = sample;
+    history.next = (history.next + 1) % HistorySize;
+    history.count = qMin(history.count + 1, static_cast<int>(HistorySize));
+}
+
+void OpenZWaveNodeStatistics::removeNode(quint8 nodeId)
+{
+    m_history.remove(nodeId);
+}
+
+QList<quint8> OpenZWaveNodeStatistics::nodes() const
+{
+    return m_history.keys();
+}
+
+OpenZWaveNodeStatistics::Sample OpenZWaveNodeStatistics::latest(quint8 nodeId) const
+{
+    QHash<quint8, History>::const_iterator it = m_history.constFind(nodeId);
+    if (it == m_history.constEnd() || it.value().count == 0) {
+        return Sample();
+    }
+    return it.value().samples[(it.value().next + HistorySize - 1) % HistorySize];
+}
+
+QList<OpenZWaveNodeStatistics::Sample> OpenZWaveNodeStatistics::history(quint8 nodeId) const
+{
+    QList<Sample> samples;
+    QHash<quint8, History>::const_iterator it = m_history.constFind(nodeId);
+    if (it == m_history.constEnd()) {
+        return samples;
+    }
+    const History &history = it.value();
+    int first = (history.next + HistorySize - history.count) % HistorySize;
+    for (int i = 0; i < history.count; i++) {
+        samples.append(history.samples[(first + i) % HistorySize]);
+    }
+    return samples;
+}
@@ -0,0 +1,79 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+*
+* Copyright (C) 2013 - 2024, nymea GmbH
+* Copyright (C) 2024 - 2025, chargebyte austria GmbH
+*
+* This file is part of nymea-zwave-plugin-openzwave.
+*
+* nymea-zwave-plugin-openzwave is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* nymea-zwave-plugin-openzwave is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with nymea-zwave-plugin-openzwave. If not, see <https://www.gnu.org/licenses/>.
+*
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef OPENZWAVENODESTATISTICS_H
+#define OPENZWAVENODESTATISTICS_H
+
+#include <Manager.h>
+
+#include <QHash>
+#include <QList>
+
+// Keeps a short history of the RF and round trip statistics OpenZWave collects per node.
+class OpenZWaveNodeStatistics
+{
+public:
+    struct Sample
+    {
+        qint64 timestamp = 0;
+        quint32 sent = 0;
+        quint32 sentFailed = 0;
+        quint32 retries = 0;
+        quint32 received = 0;
+        quint32 receivedDuplicates = 0;
+        quint32 receivedUnsolicited = 0;
+        quint32 lastRequestRtt = 0;
+        quint32 averageRequestRtt = 0;
+        quint32 lastResponseRtt = 0;
+        quint32 averageResponseRtt = 0;
+        quint8 linkQuality = 0;
+        // Only available with OpenZWave 1.6
+        quint8 hops = 0;
+        quint16 txTime = 0;
+    };
+
+    static const int HistorySize = 32;
+
+    static Sample sample(const OpenZWave::Node::NodeData &nodeData, qint64 now);
+
+    void add(quint8 nodeId, const Sample &sample);
+    void removeNode(quint8 nodeId);
+
+    QList<quint8> nodes() const;
+    Sample latest(quint8 nodeId) const;
+    // Oldest sample first
+    QList<Sample> history(quint8 nodeId) const;
+
+private:
+    struct History
+    {
+        Sample samples[HistorySize];
+        int next = 0;
+        int count = 0;
+    };
+
+    QHash<quint8, History> m_history;
+};
+
+#endif // OPENZWAVENODESTATISTICS_H
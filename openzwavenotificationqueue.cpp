@@ -0,0 +1,66 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+*
+* Copyright (C) 2013 - 2024, nymea GmbH
+* Copyright (C) 2024 - 2025, chargebyte austria GmbH
+*
+* This file is part of nymea-zwave-plugin-openzwave.
+*
+* nymea-zwave-plugin-openzwave is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* nymea-zwave-plugin-openzwave is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with nymea-zwave-plugin-openzwave. If not, see <https://www.gnu.org/licenses/>.
+*
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "openzwavenotificationqueue.h"
+
+bool OpenZWaveNotificationQueue::enqueue(const OpenZWaveNotificationRecord &record)
+{
+    m_enqueued.fetch_add(1, std::memory_order_relaxed);
+
+    if (!m_spilling.load(std::memory_order_acquire)) {
+        const quint32 head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail.load(std::memory_order_acquire) < Capacity) {
+            m_ring[head & (Capacity - 1)] = record;
+            m_head.store(head + 1, std::memory_order_release);
+            return !m_wakeupPending.exchange(true, std::memory_order_acq_rel);
+        }
+    }
+
+    m_overflows.fetch_add(1, std::memory_order_relaxed);
+    m_spillMutex.lock();
+    m_spill.append(record);
+    m_spilling.store(true, std::memory_order_release);
+    m_spillMutex.unlock();
+    return !m_wakeupPending.exchange(true, std::memory_order_acq_rel);
+}
+
+OpenZWaveNotificationQueue::Statistics OpenZWaveNotificationQueue::statistics() const
+{
+    Statistics statistics;
+    statistics.enqueued = m_enqueued.load(std::memory_order_relaxed);
+    statistics.overflows = m_overflows.load(std::memory_order_relaxed);
+    statistics.drains = m_drains;
+    statistics.drained = m_drained;
+    statistics.lastBatchSize = m_lastBatchSize;
+    statistics.maxBatchSize = m_maxBatchSize;
+    return statistics;
+}
+
+void OpenZWaveNotificationQueue::updateDrainStatistics(int batchSize)
+{
+    m_drains++;
+    m_drained += batchSize;
+    m_lastBatchSize = batchSize;
+    m_maxBatchSize = qMax(m_maxBatchSize, batchSize);
+}
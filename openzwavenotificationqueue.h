@@ -0,0 +1,136 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+*
+* Copyright (C) 2013 - 2024, nymea GmbH
+* Copyright (C) 2024 - 2025, chargebyte austria GmbH
+*
+* This file is part of nymea-zwave-plugin-openzwave.
+*
+* nymea-zwave-plugin-openzwave is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* nymea-zwave-plugin-openzwave is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with nymea-zwave-plugin-openzwave. If not, see <https://www.gnu.org/licenses/>.
+*
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef OPENZWAVENOTIFICATIONQUEUE_H
+#define OPENZWAVENOTIFICATIONQUEUE_H
+
+#include <QMutex>
+#include <QVector>
+
+#include <atomic>
+
+// A compact copy of an OpenZWave::Notification. ValueID fields can be decoded again from homeId and valueId.
+struct OpenZWaveNotificationRecord
+{
+    quint8 type = 0;
+    quint8 nodeId = 0;
+    quint8 code = 0; // Notification code or controller state, depending on the type
+    quint8 command = 0; // Controller command
+    quint32 homeId = 0;
+    quint64 valueId = 0;
+    quint64 timestamp = 0; // Microseconds on the backend clock, set when enqueued
+};
+
+// Single producer (the OpenZWave notification thread), single consumer (the Qt thread) queue.
+// OpenZWave serializes watcher callbacks, also with multiple drivers, so there is only ever one producer.
+// If the ring runs full, records are spilled to a locked list instead of being dropped. Once spilling,
+// the producer keeps spilling until the consumer caught up in order to preserve the notification order.
+class OpenZWaveNotificationQueue
+{
+public:
+    struct Statistics
+    {
+        quint64 enqueued = 0;
+        quint64 overflows = 0;
+        quint64 drains = 0;
+        quint64 drained = 0;
+        int lastBatchSize = 0;
+        int maxBatchSize = 0;
+    };
+
+    static const quint32 Capacity = 4096;
+
+    // Producer side. Returns true if the consumer needs to be woken up to drain the queue.
+    bool enqueue(const OpenZWaveNotificationRecord &record);
+
+    // Consumer side. Hands all pending records to handler in order and returns the batch size.
+    template <typename Handler>
+    int drain(Handler handler);
+
+    Statistics statistics() const;
+
+private:
+    void updateDrainStatistics(int batchSize);
+
+    OpenZWaveNotificationRecord m_ring[Capacity];
+    alignas(64) std::atomic<quint32> m_head{0};
+    alignas(64) std::atomic<quint32> m_tail{0};
+    alignas(64) std::atomic<bool> m_wakeupPending{false};
+    std::atomic<bool> m_spilling{false};
+    std::atomic<quint64> m_enqueued{0};
+    std::atomic<quint64> m_overflows{0};
+
+    QMutex m_spillMutex;
+    QVector<OpenZWaveNotificationRecord> m_spill;
+
+    // Only accessed by the consumer
+    quint64 m_drains = 0;
+    quint64 m_drained = 0;
+    int m_lastBatchSize = 0;
+    int m_maxBatchSize = 0;
+};
+
+template <typename Handler>
+int OpenZWaveNotificationQueue::drain(Handler handler)
+{
+    // Reset before looking at the ring so a record enqueued from now on will schedule a new wakeup
+    m_wakeupPending.store(false, std::memory_order_release);
+
+    int batchSize = 0;
+    forever {
+        quint32 tail = m_tail.load(std::memory_order_relaxed);
+        const quint32 head = m_head.load(std::memory_order_acquire);
+        while (tail != head) {
+            const OpenZWaveNotificationRecord record = m_ring[tail & (Capacity - 1)];
+            m_tail.store(++tail, std::memory_order_release);
+            handler(record);
+            batchSize++;
+        }
+
+        if (!m_spilling.load(std::memory_order_acquire)) {
+            break;
+        }
+        // The producer only spills once the ring is full, so it may have filled the ring further after the head
+        // was read above. Those records are older than the spilled ones. The ring doesn't grow while spilling.
+        if (m_head.load(std::memory_order_acquire) != tail) {
+            continue;
+        }
+
+        QVector<OpenZWaveNotificationRecord> spill;
+        m_spillMutex.lock();
+        spill.swap(m_spill);
+        m_spilling.store(false, std::memory_order_release);
+        m_spillMutex.unlock();
+
+        foreach (const OpenZWaveNotificationRecord &record, spill) {
+            handler(record);
+            batchSize++;
+        }
+    }
+
+    updateDrainStatistics(batchSize);
+    return batchSize;
+}
+
+#endif // OPENZWAVENOTIFICATIONQUEUE_H
@@ -0,0 +1,109 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+*
+* Copyright (C) 2013 - 2024, nymea GmbH
+* Copyright (C) 2024 - 2025, chargebyte austria GmbH
+*
+* This file is part of nymea-zwave-plugin-openzwave.
+*
+* nymea-zwave-plugin-openzwave is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* nymea-zwave-plugin-openzwave is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with nymea-zwave-plugin-openzwave. If not, see <https://www.gnu.org/licenses/>.
+*
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "openzwavepollingengine.h"
+
+void OpenZWavePollingEngine::addValue(quint64 valueId, quint8 nodeId, quint8 configuredIntensity)
+{
+    PolledValue value;
+    value.nodeId = nodeId;
+    value.configuredIntensity = qMax<quint8>(1, configuredIntensity);
+    value.intensity = value.configuredIntensity;
+    m_values.insert(valueId, value);
+}
+
+void OpenZWavePollingEngine::removeValue(quint64 valueId)
+{
+    m_values.remove(valueId);
+}
+
+void OpenZWavePollingEngine::removeNode(quint8 nodeId)
+{
+    QHash<quint64, PolledValue>::iterator it = m_values.begin();
+    while (it != m_values.end()) {
+        if (it.value().nodeId == nodeId) {
+            it = m_values.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+quint8 OpenZWavePollingEngine::valueReported(quint64 valueId, bool changed)
+{
+    QHash<quint64, PolledValue>::iterator it = m_values.find(valueId);
+    if (it == m_values.end()) {
+        return 0;
+    }
+    PolledValue &value = it.value();
+
+    if (changed) {
+        value.unchangedReports = 0;
+        return setIntensity(value, value.intensity / 2);
+    }
+
+    if (++value.unchangedReports < BackoffThreshold) {
+        return 0;
+    }
+    value.unchangedReports = 0;
+    return setIntensity(value, value.intensity * 2);
+}
+
+quint8 OpenZWavePollingEngine::valueWritten(quint64 valueId)
+{
+    QHash<quint64, PolledValue>::iterator it = m_values.find(valueId);
+    if (it == m_values.end()) {
+        return 0;
+    }
+    it.value().unchangedReports = 0;
+    return setIntensity(it.value(), it.value().configuredIntensity);
+}
+
+bool OpenZWavePollingEngine::isPolled(quint64 valueId) const
+{
+    return m_values.contains(valueId);
+}
+
+OpenZWavePollingEngine::Statistics OpenZWavePollingEngine::statistics() const
+{
+    Statistics statistics;
+    statistics.polledValues = m_values.count();
+    statistics.intensityChanges = m_intensityChanges;
+    foreach (const PolledValue &value, m_values) {
+        statistics.fixedPollsPerCycle += 1.0 / value.configuredIntensity;
+        statistics.adaptivePollsPerCycle += 1.0 / value.intensity;
+    }
+    return statistics;
+}
+
+quint8 OpenZWavePollingEngine::setIntensity(PolledValue &value, int intensity)
+{
+    intensity = qBound<int>(value.configuredIntensity, intensity, qMax<int>(value.configuredIntensity, MaxIntensity));
+    if (intensity == value.intensity) {
+        return 0;
+    }
+    value.intensity = intensity;
+    m_intensityChanges++;
+    return value.intensity;
+}
@@ -0,0 +1,78 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+*
+* Copyright (C) 2013 - 2024, nymea GmbH
+* Copyright (C) 2024 - 2025, chargebyte austria GmbH
+*
+* This file is part of nymea-zwave-plugin-openzwave.
+*
+* nymea-zwave-plugin-openzwave is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* nymea-zwave-plugin-openzwave is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with nymea-zwave-plugin-openzwave. If not, see <https://www.gnu.org/licenses/>.
+*
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef OPENZWAVEPOLLINGENGINE_H
+#define OPENZWAVEPOLLINGENGINE_H
+
+#include <QHash>
+
+// Adapts the poll intensity of each polled value. OpenZWave polls a value every <intensity> poll cycles.
+// Values which keep reporting the same value back off exponentially, values which change or have just been
+// written to are polled more often again. The engine only computes intensities, applying them is up to the caller.
+class OpenZWavePollingEngine
+{
+public:
+    struct Statistics
+    {
+        int polledValues = 0;
+        // Polls per poll cycle with the intensities configured in OpenZWave vs. the adapted ones
+        double fixedPollsPerCycle = 0;
+        double adaptivePollsPerCycle = 0;
+        quint64 intensityChanges = 0;
+
+        // The share of poll traffic (and thus RF airtime) saved compared to the fixed intensities
+        double savedRatio() const { return fixedPollsPerCycle > 0 ? 1 - adaptivePollsPerCycle / fixedPollsPerCycle : 0; }
+    };
+
+    static const quint8 MaxIntensity = 64;
+    // Number of unchanged reports at the current intensity before backing off
+    static const int BackoffThreshold = 3;
+
+    void addValue(quint64 valueId, quint8 nodeId, quint8 configuredIntensity);
+    void removeValue(quint64 valueId);
+    void removeNode(quint8 nodeId);
+
+    // Each of these returns the new intensity if it needs to be changed, 0 otherwise
+    quint8 valueReported(quint64 valueId, bool changed);
+    quint8 valueWritten(quint64 valueId);
+
+    bool isPolled(quint64 valueId) const;
+    Statistics statistics() const;
+
+private:
+    struct PolledValue
+    {
+        quint8 nodeId = 0;
+        quint8 configuredIntensity = 1;
+        quint8 intensity = 1;
+        int unchangedReports = 0;
+    };
+
+    quint8 setIntensity(PolledValue &value, int intensity);
+
+    QHash<quint64, PolledValue> m_values;
+    quint64 m_intensityChanges = 0;
+};
+
+#endif // OPENZWAVEPOLLINGENGINE_H
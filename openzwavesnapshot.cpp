@@ -0,0 +1,287 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+*
+* Copyright (C) 2013 - 2024, nymea GmbH
+* Copyright (C) 2024 - 2025, chargebyte austria GmbH
+*
+* This file is part of nymea-zwave-plugin-openzwave.
+*
+* nymea-zwave-plugin-openzwave is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* nymea-zwave-plugin-openzwave is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with nymea-zwave-plugin-openzwave. If not, see <https://www.gnu.org/licenses/>.
+*
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "openzwavesnapshot.h"
+#include "openzwavenetwork.h"
+
+#include <QFile>
+#include <QSaveFile>
+#include <QDataStream>
+#include <QByteArray>
+#include <QVector>
+
+#include <cstring>
+
+namespace {
+
+// The values are serialized with a fixed stream version, so the format doesn't change with the Qt version
+const QDataStream::Version DataStreamVersion = QDataStream::Qt_5_12;
+
+// All records are plain, naturally aligned structs so they can be read from the mapped file directly
+struct StringRef
+{
+    quint32 offset;
+    quint32 size;
+};
+
+struct Header
+{
+    char magic[4];
+    quint32 version;
+    quint32 homeId;
+    quint32 nodeCount;
+    quint32 valueCount;
+    quint32 stringsOffset;
+    quint32 stringsSize;
+    quint32 dataOffset;
+    quint32 dataSize;
+    quint32 reserved;
+};
+
+struct NodeRecord
+{
+    quint16 manufacturerId;
+    quint16 productId;
+    quint16 productType;
+    quint16 deviceType;
+    quint8 nodeId;
+    quint8 basic;
+    quint8 role;
+    quint8 security;
+    quint8 version;
+    quint8 plusType;
+    quint8 flags;
+    quint8 reserved;
+    StringRef name;
+    StringRef manufacturerName;
+    StringRef productName;
+};
+
+struct ValueRecord
+{
+    quint64 id;
+    quint16 index;
+    quint16 commandClass;
+    quint8 nodeId;
+    quint8 genre;
+    quint8 instance;
+    quint8 type;
+    qint32 selection;
+    StringRef description;
+    StringRef data;
+    quint32 reserved;
+};
+
+Q_STATIC_ASSERT(sizeof(Header) == 40);
+Q_STATIC_ASSERT(sizeof(NodeRecord) == 40);
+Q_STATIC_ASSERT(sizeof(ValueRecord) == 40);
+
+const char magic[4] = {'O', 'Z', 'W', 'S'};
+
+enum NodeFlag {
+    NodeFlagInfoValid = 0x01,
+    NodeFlagZWavePlus = 0x02,
+    NodeFlagBeaming = 0x04,
+    NodeFlagSecure = 0x08
+};
+
+StringRef appendString(QByteArray &strings, const QString &string)
+{
+    QByteArray utf8 = string.toUtf8();
+    StringRef ref;
+    ref.offset = strings.size();
+    ref.size = utf8.size();
+    strings.append(utf8);
+    return ref;
+}
+
+QString readString(const QByteArray &strings, const StringRef &ref)
+{
+    if (ref.offset > static_cast<quint32>(strings.size()) || ref.size > strings.size() - ref.offset) {
+        return QString();
+    }
+    return QString::fromUtf8(strings.constData() + ref.offset, ref.size);
+}
+
+}
+
+bool OpenZWaveSnapshot::save(const QString &fileName, const OpenZWaveNetwork *network)
+{
+    QVector<NodeRecord> nodes;
+    QVector<ValueRecord> values;
+    QByteArray strings;
+    QByteArray data;
+
+    for (int nodeId = 1; nodeId <= OpenZWaveNetwork::MaxNodes; nodeId++) {
+        const OpenZWaveNodeInfo &info = network->nodes[nodeId - 1];
+        if (!info.valid && !network->values.contains(nodeId)) {
+            continue;
+        }
+        NodeRecord node;
+        memset(&node, 0, sizeof(node));
+        node.nodeId = nodeId;
+        if (info.valid) {
+            node.manufacturerId = info.manufacturerId;
+            node.productId = info.productId;
+            node.productType = info.productType;
+            node.deviceType = info.deviceType;
+            node.basic = info.basic;
+            node.role = info.role;
+            node.security = info.security;
+            node.version = info.version;
+            node.plusType = info.plusType;
+            node.flags = NodeFlagInfoValid
+                    | (info.zwavePlus ? NodeFlagZWavePlus : 0)
+                    | (info.beaming ? NodeFlagBeaming : 0)
+                    | (info.secure ? NodeFlagSecure : 0);
+            node.name = appendString(strings, info.name);
+            node.manufacturerName = appendString(strings, info.manufacturerName);
+            node.productName = appendString(strings, info.productName);
+        }
+        nodes.append(node);
+
+        foreach (const ZWaveValue &value, network->values.value(nodeId)) {
+            ValueRecord record;
+            memset(&record, 0, sizeof(record));
+            record.id = value.id();
+            record.index = value.index();
+            record.commandClass = value.commandClass();
+            record.nodeId = nodeId;
+            record.genre = value.genre();
+            record.instance = value.instance();
+            record.type = value.type();
+            record.selection = value.valueListSelection();
+            record.description = appendString(strings, value.description());
+
+            QByteArray serialized;
+            QDataStream stream(&serialized, QIODevice::WriteOnly);
+            stream.setVersion(DataStreamVersion);
+            stream << value.value();
+            record.data.offset = data.size();
+            record.data.size = serialized.size();
+            data.append(serialized);
+            values.append(record);
+        }
+    }
+
+    Header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, magic, sizeof(magic));
+    header.version = Version;
+    header.homeId = network->homeId;
+    header.nodeCount = nodes.count();
+    header.valueCount = values.count();
+    header.stringsOffset = sizeof(Header) + nodes.count() * sizeof(NodeRecord) + values.count() * sizeof(ValueRecord);
+    header.stringsSize = strings.size();
+    header.dataOffset = header.stringsOffset + header.stringsSize;
+    header.dataSize = data.size();
+
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(nodes.constData()), nodes.count() * sizeof(NodeRecord));
+    file.write(reinterpret_cast<const char*>(values.constData()), values.count() * sizeof(ValueRecord));
+    file.write(strings);
+    file.write(data);
+    return file.commit();
+}
+
+quint32 OpenZWaveSnapshot::load(const QString &fileName, OpenZWaveNetwork *network)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return 0;
+    }
+    qint64 fileSize = file.size();
+    const uchar *map = file.map(0, fileSize);
+    if (!map) {
+        return 0;
+    }
+
+    // Validate everything before touching the network, truncated, foreign or outdated files are just ignored
+    const Header *header = reinterpret_cast<const Header*>(map);
+    if (fileSize < static_cast<qint64>(sizeof(Header)) || memcmp(header->magic, magic, sizeof(magic)) != 0 || header->version != Version) {
+        return 0;
+    }
+    qint64 recordsEnd = sizeof(Header) + static_cast<qint64>(header->nodeCount) * sizeof(NodeRecord) + static_cast<qint64>(header->valueCount) * sizeof(ValueRecord);
+    if (recordsEnd > header->stringsOffset
+            || static_cast<qint64>(header->stringsOffset) + header->stringsSize > header->dataOffset
+            || static_cast<qint64>(header->dataOffset) + header->dataSize > fileSize) {
+        return 0;
+    }
+
+    const NodeRecord *nodes = reinterpret_cast<const NodeRecord*>(map + sizeof(Header));
+    const ValueRecord *values = reinterpret_cast<const ValueRecord*>(nodes + header->nodeCount);
+    QByteArray strings = QByteArray::fromRawData(reinterpret_cast<const char*>(map + header->stringsOffset), header->stringsSize);
+
+    for (quint32 i = 0; i < header->nodeCount; i++) {
+        const NodeRecord &node = nodes[i];
+        OpenZWaveNodeInfo *info = network->nodeInfo(node.nodeId);
+        if (!info || !(node.flags & NodeFlagInfoValid)) {
+            continue;
+        }
+        info->valid = true;
+        info->name = readString(strings, node.name);
+        info->manufacturerName = readString(strings, node.manufacturerName);
+        info->productName = readString(strings, node.productName);
+        info->manufacturerId = node.manufacturerId;
+        info->productId = node.productId;
+        info->productType = node.productType;
+        info->deviceType = node.deviceType;
+        info->basic = node.basic;
+        info->role = node.role;
+        info->security = node.security;
+        info->version = node.version;
+        info->plusType = node.plusType;
+        info->zwavePlus = node.flags & NodeFlagZWavePlus;
+        info->beaming = node.flags & NodeFlagBeaming;
+        info->secure = node.flags & NodeFlagSecure;
+    }
+
+    for (quint32 i = 0; i < header->valueCount; i++) {
+        const ValueRecord &record = values[i];
+        if (record.data.size > header->dataSize || record.data.offset > header->dataSize - record.data.size) {
+            continue;
+        }
+        QVariant variant;
+        QByteArray serialized = QByteArray::fromRawData(reinterpret_cast<const char*>(map + header->dataOffset + record.data.offset), record.data.size);
+        QDataStream stream(serialized);
+        stream.setVersion(DataStreamVersion);
+        stream >> variant;
+
+        ZWaveValue value(record.id,
+                         static_cast<ZWaveValue::Genre>(record.genre),
+                         static_cast<ZWaveValue::CommandClass>(record.commandClass),
+                         record.instance,
+                         record.index,
+                         static_cast<ZWaveValue::Type>(record.type),
+                         readString(strings, record.description));
+        value.setValue(variant, record.selection);
+        network->values[record.nodeId].insert(record.id, value);
+    }
+
+    return header->homeId;
+}
@@ -0,0 +1,49 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+*
+* Copyright (C) 2013 - 2024, nymea GmbH
+* Copyright (C) 2024 - 2025, chargebyte austria GmbH
+*
+* This file is part of nymea-zwave-plugin-openzwave.
+*
+* nymea-zwave-plugin-openzwave is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* nymea-zwave-plugin-openzwave is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with nymea-zwave-plugin-openzwave. If not, see <https://www.gnu.org/licenses/>.
+*
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef OPENZWAVESNAPSHOT_H
+#define OPENZWAVESNAPSHOT_H
+
+#include <QString>
+
+class OpenZWaveNetwork;
+
+// Compact binary copy of the nodes and values of a network, used to present the network right away
+// on startup while OpenZWave is still interviewing. The file consists of a header followed by fixed size
+// node and value records, a string table and the serialized values. It is read through a memory map,
+// records are used in place.
+class OpenZWaveSnapshot
+{
+public:
+    // 2: values serialized with QDataStream::Qt_5_12
+    static const quint32 Version = 2;
+
+    static bool save(const QString &fileName, const OpenZWaveNetwork *network);
+
+    // Fills node infos and values of the network. Returns the home id the snapshot was taken for,
+    // 0 if there is no usable snapshot.
+    static quint32 load(const QString &fileName, OpenZWaveNetwork *network);
+};
+
+#endif // OPENZWAVESNAPSHOT_H
@@ -0,0 +1,123 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+*
+* Copyright (C) 2013 - 2024, nymea GmbH
+* Copyright (C) 2024 - 2025, chargebyte austria GmbH
+*
+* This file is part of nymea-zwave-plugin-openzwave.
+*
+* nymea-zwave-plugin-openzwave is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* nymea-zwave-plugin-openzwave is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with nymea-zwave-plugin-openzwave. If not, see <https://www.gnu.org/licenses/>.
+*
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "openzwavetrace.h"
+
+#include <cstring>
+
+namespace {
+
+struct Header
+{
+    char magic[4];
+    quint32 version;
+    quint32 recordSize;
+    quint32 reserved;
+};
+
+const char magic[4] = {'O', 'Z', 'W', 'T'};
+
+const int BufferSize = 1024;
+
+}
+
+OpenZWaveTrace::~OpenZWaveTrace()
+{
+    close();
+}
+
+bool OpenZWaveTrace::open(const QString &fileName)
+{
+    close();
+    m_file.setFileName(fileName);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    Header header;
+    memcpy(header.magic, magic, sizeof(magic));
+    header.version = Version;
+    header.recordSize = sizeof(OpenZWaveNotificationRecord);
+    header.reserved = 0;
+    m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    m_buffer.reserve(BufferSize);
+    m_count = 0;
+    return true;
+}
+
+void OpenZWaveTrace::close()
+{
+    if (!m_file.isOpen()) {
+        return;
+    }
+    flush();
+    m_file.close();
+}
+
+bool OpenZWaveTrace::isOpen() const
+{
+    return m_file.isOpen();
+}
+
+void OpenZWaveTrace::write(const OpenZWaveNotificationRecord &record)
+{
+    m_buffer.append(record);
+    m_count++;
+    if (m_buffer.count() >= BufferSize) {
+        flush();
+    }
+}
+
+quint64 OpenZWaveTrace::count() const
+{
+    return m_count;
+}
+
+bool OpenZWaveTrace::load(const QString &fileName, QVector<OpenZWaveNotificationRecord> *records)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    Header header;
+    if (file.read(reinterpret_cast<char*>(&header), sizeof(header)) != sizeof(header)
+            || memcmp(header.magic, magic, sizeof(magic)) != 0
+            || header.version != Version
+            || header.recordSize != sizeof(OpenZWaveNotificationRecord)) {
+        return false;
+    }
+    // A trace which hasn't been closed properly may end with a partial record
+    qint64 count = (file.size() - static_cast<qint64>(sizeof(header))) / header.recordSize;
+    records->resize(count);
+    qint64 size = count * header.recordSize;
+    return file.read(reinterpret_cast<char*>(records->data()), size) == size;
+}
+
+void OpenZWaveTrace::flush()
+{
+    if (m_buffer.isEmpty()) {
+        return;
+    }
+    m_file.write(reinterpret_cast<const char*>(m_buffer.constData()), m_buffer.count() * sizeof(OpenZWaveNotificationRecord));
+    m_buffer.clear();
+}
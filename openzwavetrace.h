@@ -0,0 +1,59 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+*
+* Copyright (C) 2013 - 2024, nymea GmbH
+* Copyright (C) 2024 - 2025, chargebyte austria GmbH
+*
+* This file is part of nymea-zwave-plugin-openzwave.
+*
+* nymea-zwave-plugin-openzwave is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* nymea-zwave-plugin-openzwave is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with nymea-zwave-plugin-openzwave. If not, see <https://www.gnu.org/licenses/>.
+*
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef OPENZWAVETRACE_H
+#define OPENZWAVETRACE_H
+
+#include "openzwavenotificationqueue.h"
+
+#include <QFile>
+#include <QVector>
+
+// Binary trace of the notification stream. A short header followed by the notification records as they
+// are kept in the queue, in host byte order. Records are written through a buffer as they are dispatched.
+class OpenZWaveTrace
+{
+public:
+    static const quint32 Version = 1;
+
+    ~OpenZWaveTrace();
+
+    bool open(const QString &fileName);
+    void close();
+    bool isOpen() const;
+
+    void write(const OpenZWaveNotificationRecord &record);
+    quint64 count() const;
+
+    static bool load(const QString &fileName, QVector<OpenZWaveNotificationRecord> *records);
+
+private:
+    void flush();
+
+    QFile m_file;
+    QVector<OpenZWaveNotificationRecord> m_buffer;
+    quint64 m_count = 0;
+};
+
+#endif // OPENZWAVETRACE_H
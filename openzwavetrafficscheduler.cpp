@@ -0,0 +1,130 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+*
+* Copyright (C) 2013 - 2024, nymea GmbH
+* Copyright (C) 2024 - 2025, chargebyte austria GmbH
+*
+* This file is part of nymea-zwave-plugin-openzwave.
+*
+* nymea-zwave-plugin-openzwave is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* nymea-zwave-plugin-openzwave is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with nymea-zwave-plugin-openzwave. If not, see <https://www.gnu.org/licenses/>.
+*
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "openzwavetrafficscheduler.h"
+
+OpenZWaveTrafficScheduler::OpenZWaveTrafficScheduler(QObject *parent):
+    QObject(parent)
+{
+    m_dispatchTimer.setSingleShot(true);
+    m_dispatchTimer.setInterval(100);
+    connect(&m_dispatchTimer, &QTimer::timeout, this, &OpenZWaveTrafficScheduler::dispatch);
+
+    m_interactiveHoldTimer.setSingleShot(true);
+    m_interactiveHoldTimer.setInterval(3000);
+    connect(&m_interactiveHoldTimer, &QTimer::timeout, this, &OpenZWaveTrafficScheduler::onInteractiveHoldExpired);
+
+    m_clock.start();
+}
+
+void OpenZWaveTrafficScheduler::schedule(Priority priority, std::function<void()> job)
+{
+    Job entry;
+    entry.job = job;
+    entry.queued = m_clock.elapsed();
+
+    if (priority == PriorityInteractive) {
+        bool wasActive = m_interactiveHoldTimer.isActive();
+        m_interactiveHoldTimer.start();
+        if (!wasActive) {
+            emit interactiveTrafficChanged(true);
+        }
+        run(priority, entry);
+        return;
+    }
+
+    m_queues[priority].enqueue(entry);
+    m_statistics[priority].queueDepth = m_queues[priority].count();
+    scheduleDispatch();
+}
+
+bool OpenZWaveTrafficScheduler::isInteractiveTrafficActive() const
+{
+    return m_interactiveHoldTimer.isActive();
+}
+
+OpenZWaveTrafficScheduler::Statistics OpenZWaveTrafficScheduler::statistics(Priority priority) const
+{
+    return m_statistics[priority];
+}
+
+void OpenZWaveTrafficScheduler::setDispatchInterval(int msecs)
+{
+    m_dispatchTimer.setInterval(msecs);
+}
+
+void OpenZWaveTrafficScheduler::setInteractiveHoldTime(int msecs)
+{
+    m_interactiveHoldTimer.setInterval(msecs);
+}
+
+void OpenZWaveTrafficScheduler::dispatch()
+{
+    for (int i = PriorityRefresh; i < PriorityCount; i++) {
+        Priority priority = static_cast<Priority>(i);
+        if (m_queues[priority].isEmpty() || isDeferred(priority)) {
+            continue;
+        }
+        Job job = m_queues[priority].dequeue();
+        m_statistics[priority].queueDepth = m_queues[priority].count();
+        run(priority, job);
+        break;
+    }
+    scheduleDispatch();
+}
+
+void OpenZWaveTrafficScheduler::onInteractiveHoldExpired()
+{
+    emit interactiveTrafficChanged(false);
+    scheduleDispatch();
+}
+
+void OpenZWaveTrafficScheduler::run(Priority priority, const Job &job)
+{
+    qint64 wait = m_clock.elapsed() - job.queued;
+    Statistics &statistics = m_statistics[priority];
+    statistics.executed++;
+    statistics.totalWait += wait;
+    statistics.maxWait = qMax(statistics.maxWait, wait);
+    job.job();
+}
+
+bool OpenZWaveTrafficScheduler::isDeferred(Priority priority) const
+{
+    return priority == PriorityMaintenance && isInteractiveTrafficActive();
+}
+
+void OpenZWaveTrafficScheduler::scheduleDispatch()
+{
+    if (m_dispatchTimer.isActive()) {
+        return;
+    }
+    for (int i = PriorityRefresh; i < PriorityCount; i++) {
+        Priority priority = static_cast<Priority>(i);
+        if (!m_queues[priority].isEmpty() && !isDeferred(priority)) {
+            m_dispatchTimer.start();
+            return;
+        }
+    }
+}
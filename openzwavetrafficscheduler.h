@@ -0,0 +1,107 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+*
+* Copyright (C) 2013 - 2024, nymea GmbH
+* Copyright (C) 2024 - 2025, chargebyte austria GmbH
+*
+* This file is part of nymea-zwave-plugin-openzwave.
+*
+* nymea-zwave-plugin-openzwave is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* nymea-zwave-plugin-openzwave is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with nymea-zwave-plugin-openzwave. If not, see <https://www.gnu.org/licenses/>.
+*
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef OPENZWAVETRAFFICSCHEDULER_H
+#define OPENZWAVETRAFFICSCHEDULER_H
+
+#include <QObject>
+#include <QQueue>
+#include <QTimer>
+#include <QElapsedTimer>
+
+#include <functional>
+
+// OpenZWave sends everything in the order it has been queued. This scheduler decides in which order and
+// how fast the backend feeds its own outbound traffic into OpenZWave. Interactive commands are executed right
+// away, everything else is queued per priority class and fed one job per dispatch interval. Maintenance jobs
+// are held back while interactive traffic is active, that is within the hold time after the last interactive
+// command.
+//
+// There is no poll class. The backend doesn't poll by itself, all polls are sent by the poll thread of
+// OpenZWave and can't be queued here. Deferring them is realized by stretching the global poll interval
+// (SetPollInterval) while interactiveTrafficChanged() reports active traffic, so a poll already due may
+// still go out in between.
+// Only jobs which actually send something should be scheduled, local settings like SetPollIntensity are
+// applied directly, so the statistics reflect outbound traffic only.
+class OpenZWaveTrafficScheduler : public QObject
+{
+    Q_OBJECT
+public:
+    enum Priority {
+        PriorityInteractive = 0,
+        PriorityRefresh,
+        PriorityMaintenance
+    };
+    Q_ENUM(Priority)
+
+    struct Statistics
+    {
+        int queueDepth = 0;
+        quint64 executed = 0;
+        qint64 totalWait = 0;
+        qint64 maxWait = 0;
+
+        qint64 averageWait() const { return executed > 0 ? totalWait / static_cast<qint64>(executed) : 0; }
+    };
+
+    explicit OpenZWaveTrafficScheduler(QObject *parent = nullptr);
+
+    // Interactive jobs run synchronously, everything else is queued
+    void schedule(Priority priority, std::function<void()> job);
+
+    bool isInteractiveTrafficActive() const;
+    Statistics statistics(Priority priority) const;
+
+    void setDispatchInterval(int msecs);
+    void setInteractiveHoldTime(int msecs);
+
+signals:
+    void interactiveTrafficChanged(bool active);
+
+private slots:
+    void dispatch();
+    void onInteractiveHoldExpired();
+
+private:
+    struct Job
+    {
+        std::function<void()> job;
+        qint64 queued;
+    };
+
+    static const int PriorityCount = PriorityMaintenance + 1;
+
+    void run(Priority priority, const Job &job);
+    bool isDeferred(Priority priority) const;
+    void scheduleDispatch();
+
+    QQueue<Job> m_queues[PriorityCount];
+    Statistics m_statistics[PriorityCount];
+
+    QTimer m_dispatchTimer;
+    QTimer m_interactiveHoldTimer;
+    QElapsedTimer m_clock;
+};
+
+#endif // OPENZWAVETRAFFICSCHEDULER_H
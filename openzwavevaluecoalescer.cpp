@@ -0,0 +1,164 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+*
+* Copyright (C) 2013 - 2024, nymea GmbH
+* Copyright (C) 2024 - 2025, chargebyte austria GmbH
+*
+* This file is part of nymea-zwave-plugin-openzwave.
+*
+* nymea-zwave-plugin-openzwave is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* nymea-zwave-plugin-openzwave is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with nymea-zwave-plugin-openzwave. If not, see <https://www.gnu.org/licenses/>.
+*
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "openzwavevaluecoalescer.h"
+
+OpenZWaveValueCoalescer::OpenZWaveValueCoalescer(QObject *parent):
+    QObject(parent)
+{
+    m_timer.setSingleShot(true);
+    connect(&m_timer, &QTimer::timeout, this, &OpenZWaveValueCoalescer::flush);
+    m_clock.start();
+}
+
+void OpenZWaveValueCoalescer::setWindow(ZWaveValue::CommandClass commandClass, int msecs)
+{
+    if (msecs >= 0) {
+        m_commandClassWindows.insert(static_cast<quint16>(commandClass), msecs);
+    } else {
+        m_commandClassWindows.remove(static_cast<quint16>(commandClass));
+    }
+}
+
+void OpenZWaveValueCoalescer::setWindow(ZWaveValue::Genre genre, int msecs)
+{
+    if (msecs > 0) {
+        m_genreWindows.insert(genre, msecs);
+    } else {
+        m_genreWindows.remove(genre);
+    }
+}
+
+bool OpenZWaveValueCoalescer::submit(const QUuid &networkUuid, quint8 nodeId, const ZWaveValue &value)
+{
+    int msecs = window(value);
+    if (msecs <= 0) {
+        return false;
+    }
+
+    m_statistics.submitted++;
+
+    Key key(networkUuid, value.id());
+    QHash<Key, PendingValue>::iterator it = m_pending.find(key);
+    if (it != m_pending.end()) {
+        // Keep the original deadline so a constantly reporting value still goes out once per window
+        it.value().value = value;
+        m_statistics.suppressed++;
+        return true;
+    }
+
+    PendingValue pending;
+    pending.nodeId = nodeId;
+    pending.value = value;
+    pending.deadline = m_clock.elapsed() + msecs;
+    m_pending.insert(key, pending);
+    scheduleFlush();
+    return true;
+}
+
+void OpenZWaveValueCoalescer::drop(const QUuid &networkUuid, quint64 valueId)
+{
+    m_pending.remove(Key(networkUuid, valueId));
+}
+
+void OpenZWaveValueCoalescer::dropNode(const QUuid &networkUuid, quint8 nodeId)
+{
+    QHash<Key, PendingValue>::iterator it = m_pending.begin();
+    while (it != m_pending.end()) {
+        if (it.key().first == networkUuid && it.value().nodeId == nodeId) {
+            it = m_pending.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void OpenZWaveValueCoalescer::dropNetwork(const QUuid &networkUuid)
+{
+    QHash<Key, PendingValue>::iterator it = m_pending.begin();
+    while (it != m_pending.end()) {
+        if (it.key().first == networkUuid) {
+            it = m_pending.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+OpenZWaveValueCoalescer::Statistics OpenZWaveValueCoalescer::statistics() const
+{
+    return m_statistics;
+}
+
+void OpenZWaveValueCoalescer::flush()
+{
+    qint64 now = m_clock.elapsed();
+
+    QList<QPair<QUuid, PendingValue> > due;
+    QHash<Key, PendingValue>::iterator it = m_pending.begin();
+    while (it != m_pending.end()) {
+        if (it.value().deadline <= now) {
+            due.append(qMakePair(it.key().first, it.value()));
+            it = m_pending.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    // Emitting may call back into submit(), so the pending list must be consistent by now
+    for (int i = 0; i < due.count(); i++) {
+        m_statistics.emitted++;
+        emit valueReady(due.at(i).first, due.at(i).second.nodeId, due.at(i).second.value);
+    }
+
+    scheduleFlush();
+}
+
+int OpenZWaveValueCoalescer::window(const ZWaveValue &value) const
+{
+    if (m_commandClassWindows.isEmpty() && m_genreWindows.isEmpty()) {
+        return 0;
+    }
+    QHash<quint16, int>::const_iterator it = m_commandClassWindows.constFind(static_cast<quint16>(value.commandClass()));
+    if (it != m_commandClassWindows.constEnd()) {
+        return it.value();
+    }
+    return m_genreWindows.value(static_cast<int>(value.genre()));
+}
+
+void OpenZWaveValueCoalescer::scheduleFlush()
+{
+    if (m_pending.isEmpty()) {
+        m_timer.stop();
+        return;
+    }
+
+    qint64 next = -1;
+    foreach (const PendingValue &pending, m_pending) {
+        if (next < 0 || pending.deadline < next) {
+            next = pending.deadline;
+        }
+    }
+    m_timer.start(static_cast<int>(qMax<qint64>(0, next - m_clock.elapsed())));
+}
@@ -0,0 +1,96 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+*
+* Copyright (C) 2013 - 2024, nymea GmbH
+* Copyright (C) 2024 - 2025, chargebyte austria GmbH
+*
+* This file is part of nymea-zwave-plugin-openzwave.
+*
+* nymea-zwave-plugin-openzwave is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* nymea-zwave-plugin-openzwave is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with nymea-zwave-plugin-openzwave. If not, see <https://www.gnu.org/licenses/>.
+*
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef OPENZWAVEVALUECOALESCER_H
+#define OPENZWAVEVALUECOALESCER_H
+
+#include <hardware/zwave/zwavevalue.h>
+
+#include <QObject>
+#include <QHash>
+#include <QPair>
+#include <QUuid>
+#include <QTimer>
+#include <QElapsedTimer>
+
+// Holds back value updates for a configurable window and only emits the latest value per value id.
+// Windows are configured per command class or per genre, a command class window takes precedence.
+// Without any window configured, all values pass through untouched.
+class OpenZWaveValueCoalescer : public QObject
+{
+    Q_OBJECT
+public:
+    struct Statistics
+    {
+        quint64 submitted = 0;
+        quint64 suppressed = 0;
+        quint64 emitted = 0;
+    };
+
+    explicit OpenZWaveValueCoalescer(QObject *parent = nullptr);
+
+    // A command class window of 0 keeps the values of that command class from being coalesced, also within a
+    // coalesced genre, e.g. for alarms or central scenes. A negative window removes the command class window,
+    // its values fall back to the genre window again.
+    void setWindow(ZWaveValue::CommandClass commandClass, int msecs);
+    // A genre window of 0 disables coalescing again
+    void setWindow(ZWaveValue::Genre genre, int msecs);
+
+    // Returns false if the value isn't coalesced and needs to be emitted by the caller right away
+    bool submit(const QUuid &networkUuid, quint8 nodeId, const ZWaveValue &value);
+
+    void drop(const QUuid &networkUuid, quint64 valueId);
+    void dropNode(const QUuid &networkUuid, quint8 nodeId);
+    void dropNetwork(const QUuid &networkUuid);
+
+    Statistics statistics() const;
+
+signals:
+    void valueReady(const QUuid &networkUuid, quint8 nodeId, const ZWaveValue &value);
+
+private slots:
+    void flush();
+
+private:
+    typedef QPair<QUuid, quint64> Key;
+    struct PendingValue {
+        quint8 nodeId;
+        ZWaveValue value;
+        qint64 deadline;
+    };
+
+    int window(const ZWaveValue &value) const;
+    void scheduleFlush();
+
+    QHash<quint16, int> m_commandClassWindows;
+    QHash<int, int> m_genreWindows;
+
+    QHash<Key, PendingValue> m_pending;
+    QTimer m_timer;
+    QElapsedTimer m_clock;
+
+    Statistics m_statistics;
+};
+
+#endif // OPENZWAVEVALUECOALESCER_H
@@ -0,0 +1,65 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+*
+* Copyright (C) 2013 - 2024, nymea GmbH
+* Copyright (C) 2024 - 2025, chargebyte austria GmbH
+*
+* This file is part of nymea-zwave-plugin-openzwave.
+*
+* nymea-zwave-plugin-openzwave is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* nymea-zwave-plugin-openzwave is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with nymea-zwave-plugin-openzwave. If not, see <https://www.gnu.org/licenses/>.
+*
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "openzwavevaluemetadata.h"
+
+QString OpenZWaveStringPool::intern(const std::string &string)
+{
+    if (string.empty()) {
+        return QString();
+    }
+    QString ret = QString::fromStdString(string);
+    QSet<QString>::const_iterator it = m_strings.constFind(ret);
+    if (it != m_strings.constEnd()) {
+        return *it;
+    }
+    m_strings.insert(ret);
+    return ret;
+}
+
+QStringList OpenZWaveStringPool::intern(const std::vector<std::string> &strings)
+{
+    QStringList ret;
+    ret.reserve(static_cast<int>(strings.size()));
+    for (const std::string &string: strings) {
+        ret.append(intern(string));
+    }
+
+    // Called on ValueAdded and when a list selection doesn't match the items any more. Both are rare
+    // compared to value changes, so building the key on each call is fine.
+    QString key = ret.join(QChar(0));
+    QHash<QString, QStringList>::const_iterator it = m_lists.constFind(key);
+    if (it != m_lists.constEnd()) {
+        return it.value();
+    }
+    if (m_lists.count() < MaxLists) {
+        m_lists.insert(key, ret);
+    }
+    return ret;
+}
+
+int OpenZWaveStringPool::count() const
+{
+    return m_strings.count() + m_lists.count();
+}
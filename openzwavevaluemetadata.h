@@ -0,0 +1,70 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+*
+* Copyright (C) 2013 - 2024, nymea GmbH
+* Copyright (C) 2024 - 2025, chargebyte austria GmbH
+*
+* This file is part of nymea-zwave-plugin-openzwave.
+*
+* nymea-zwave-plugin-openzwave is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* nymea-zwave-plugin-openzwave is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with nymea-zwave-plugin-openzwave. If not, see <https://www.gnu.org/licenses/>.
+*
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef OPENZWAVEVALUEMETADATA_H
+#define OPENZWAVEVALUEMETADATA_H
+
+#include <QString>
+#include <QStringList>
+#include <QSet>
+#include <QHash>
+#include <QVector>
+
+#include <string>
+#include <vector>
+
+// Value properties which don't change after ValueAdded, except for list items which are read again if a
+// selection doesn't match them any more. Strings are interned, so the same help text or list item table
+// of many values shares one copy in memory.
+class OpenZWaveValueMetadata
+{
+public:
+    QString help;
+    QString units;
+    QStringList listItems;
+    // The values of the list items, which is what OpenZWave reports as selection
+    QVector<qint32> listValues;
+    qint32 min = 0;
+    qint32 max = 0;
+};
+
+// Interned strings are never released. Their number is bound by the OpenZWave config database.
+// List tables can also come from devices changing their items at runtime, so only the first MaxLists
+// distinct tables are interned, further ones are handed out as plain copies.
+class OpenZWaveStringPool
+{
+public:
+    static const int MaxLists = 1024;
+
+    QString intern(const std::string &string);
+    QStringList intern(const std::vector<std::string> &strings);
+
+    int count() const;
+
+private:
+    QSet<QString> m_strings;
+    QHash<QString, QStringList> m_lists;
+};
+
+#endif // OPENZWAVEVALUEMETADATA_H
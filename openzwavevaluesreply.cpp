@@ -0,0 +1,44 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+*
+* Copyright (C) 2013 - 2024, nymea GmbH
+* Copyright (C) 2024 - 2025, chargebyte austria GmbH
+*
+* This file is part of nymea-zwave-plugin-openzwave.
+*
+* nymea-zwave-plugin-openzwave is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* nymea-zwave-plugin-openzwave is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with nymea-zwave-plugin-openzwave. If not, see <https://www.gnu.org/licenses/>.
+*
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "openzwavevaluesreply.h"
+
+OpenZWaveValuesReply::OpenZWaveValuesReply(QObject *parent):
+    ZWaveReply(parent)
+{
+}
+
+QList<OpenZWaveValuesReply::Result> OpenZWaveValuesReply::results() const
+{
+    return m_results;
+}
+
+void OpenZWaveValuesReply::addResult(quint8 nodeId, quint64 valueId, ZWave::ZWaveError error)
+{
+    Result result;
+    result.nodeId = nodeId;
+    result.valueId = valueId;
+    result.error = error;
+    m_results.append(result);
+}
@@ -0,0 +1,53 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+*
+* Copyright (C) 2013 - 2024, nymea GmbH
+* Copyright (C) 2024 - 2025, chargebyte austria GmbH
+*
+* This file is part of nymea-zwave-plugin-openzwave.
+*
+* nymea-zwave-plugin-openzwave is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* nymea-zwave-plugin-openzwave is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with nymea-zwave-plugin-openzwave. If not, see <https://www.gnu.org/licenses/>.
+*
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef OPENZWAVEVALUESREPLY_H
+#define OPENZWAVEVALUESREPLY_H
+
+#include <hardware/zwave/zwavereply.h>
+
+#include <QList>
+
+// Reply of a batched write, carrying the result for each value that has been written.
+class OpenZWaveValuesReply : public ZWaveReply
+{
+    Q_OBJECT
+public:
+    struct Result
+    {
+        quint8 nodeId;
+        quint64 valueId;
+        ZWave::ZWaveError error;
+    };
+
+    explicit OpenZWaveValuesReply(QObject *parent = nullptr);
+
+    QList<Result> results() const;
+    void addResult(quint8 nodeId, quint64 valueId, ZWave::ZWaveError error);
+
+private:
+    QList<Result> m_results;
+};
+
+#endif // OPENZWAVEVALUESREPLY_H
@@ -0,0 +1,88 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+*
+* Copyright (C) 2013 - 2024, nymea GmbH
+* Copyright (C) 2024 - 2025, chargebyte austria GmbH
+*
+* This file is part of nymea-zwave-plugin-openzwave.
+*
+* nymea-zwave-plugin-openzwave is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* nymea-zwave-plugin-openzwave is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with nymea-zwave-plugin-openzwave. If not, see <https://www.gnu.org/licenses/>.
+*
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "openzwavewakeupqueue.h"
+
+void OpenZWaveWakeUpQueue::add(quint8 nodeId, const ZWaveValue &value)
+{
+    QList<ZWaveValue> &writes = m_pendingWrites[nodeId];
+    for (int i = 0; i < writes.count(); i++) {
+        if (writes.at(i).id() == value.id()) {
+            writes[i] = value;
+            m_statistics.collapsed++;
+            return;
+        }
+    }
+    writes.append(value);
+    m_statistics.queued++;
+}
+
+QList<ZWaveValue> OpenZWaveWakeUpQueue::take(quint8 nodeId)
+{
+    QList<ZWaveValue> writes = m_pendingWrites.take(nodeId);
+    m_statistics.flushed += writes.count();
+    return writes;
+}
+
+void OpenZWaveWakeUpQueue::dropValue(quint8 nodeId, quint64 valueId)
+{
+    QHash<quint8, QList<ZWaveValue> >::iterator it = m_pendingWrites.find(nodeId);
+    if (it == m_pendingWrites.end()) {
+        return;
+    }
+    for (int i = 0; i < it.value().count(); i++) {
+        if (it.value().at(i).id() == valueId) {
+            it.value().removeAt(i);
+            m_statistics.dropped++;
+            break;
+        }
+    }
+    if (it.value().isEmpty()) {
+        m_pendingWrites.erase(it);
+    }
+}
+
+void OpenZWaveWakeUpQueue::dropNode(quint8 nodeId)
+{
+    m_statistics.dropped += m_pendingWrites.take(nodeId).count();
+}
+
+QList<ZWaveValue> OpenZWaveWakeUpQueue::pendingWrites(quint8 nodeId) const
+{
+    return m_pendingWrites.value(nodeId);
+}
+
+int OpenZWaveWakeUpQueue::count() const
+{
+    int count = 0;
+    foreach (const QList<ZWaveValue> &writes, m_pendingWrites) {
+        count += writes.count();
+    }
+    return count;
+}
+
+OpenZWaveWakeUpQueue::Statistics OpenZWaveWakeUpQueue::statistics() const
+{
+    return m_statistics;
+}
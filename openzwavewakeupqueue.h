@@ -0,0 +1,62 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+*
+* Copyright (C) 2013 - 2024, nymea GmbH
+* Copyright (C) 2024 - 2025, chargebyte austria GmbH
+*
+* This file is part of nymea-zwave-plugin-openzwave.
+*
+* nymea-zwave-plugin-openzwave is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* nymea-zwave-plugin-openzwave is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with nymea-zwave-plugin-openzwave. If not, see <https://www.gnu.org/licenses/>.
+*
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef OPENZWAVEWAKEUPQUEUE_H
+#define OPENZWAVEWAKEUPQUEUE_H
+
+#include <hardware/zwave/zwavevalue.h>
+
+#include <QHash>
+#include <QList>
+
+// Holds back writes to sleeping nodes until they wake up. Of multiple writes to the same value only the
+// last one is kept, at the position of the first one.
+class OpenZWaveWakeUpQueue
+{
+public:
+    struct Statistics
+    {
+        quint64 queued = 0;
+        quint64 collapsed = 0;
+        quint64 flushed = 0;
+        quint64 dropped = 0;
+    };
+
+    void add(quint8 nodeId, const ZWaveValue &value);
+    // Takes the writes of a node to send them
+    QList<ZWaveValue> take(quint8 nodeId);
+    // Discards writes which can't be sent any more, e.g. because the value or the node is gone
+    void dropValue(quint8 nodeId, quint64 valueId);
+    void dropNode(quint8 nodeId);
+
+    QList<ZWaveValue> pendingWrites(quint8 nodeId) const;
+    int count() const;
+    Statistics statistics() const;
+
+private:
+    QHash<quint8, QList<ZWaveValue> > m_pendingWrites;
+    Statistics m_statistics;
+};
+
+#endif // OPENZWAVEWAKEUPQUEUE_H
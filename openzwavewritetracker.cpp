@@ -0,0 +1,170 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+*
+* Copyright (C) 2013 - 2024, nymea GmbH
+* Copyright (C) 2024 - 2025, chargebyte austria GmbH
+*
+* This file is part of nymea-zwave-plugin-openzwave.
+*
+* nymea-zwave-plugin-openzwave is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* nymea-zwave-plugin-openzwave is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with nymea-zwave-plugin-openzwave. If not, see <https://www.gnu.org/licenses/>.
+*
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "openzwavewritetracker.h"
+
+void OpenZWaveWriteTracker::add(quint8 nodeId, quint64 valueId, ZWaveReply *reply, qint64 now, int messagesAhead)
+{
+    PendingWrite write;
+    write.nodeId = nodeId;
+    write.reply = reply;
+    write.started = now;
+    write.messagesAhead = messagesAhead;
+    m_pendingWrites[valueId].append(write);
+    m_count++;
+}
+
+void OpenZWaveWriteTracker::sent(quint64 valueId, int messagesAhead)
+{
+    QHash<quint64, QList<PendingWrite> >::iterator it = m_pendingWrites.find(valueId);
+    if (it == m_pendingWrites.end()) {
+        return;
+    }
+    for (int i = 0; i < it.value().count(); i++) {
+        if (it.value().at(i).messagesAhead == NotSent) {
+            it.value()[i].messagesAhead = messagesAhead;
+        }
+    }
+}
+
+void OpenZWaveWriteTracker::remove(ZWaveReply *reply)
+{
+    QHash<quint64, QList<PendingWrite> >::iterator it = m_pendingWrites.begin();
+    while (it != m_pendingWrites.end()) {
+        QList<PendingWrite> &writes = it.value();
+        for (int i = writes.count() - 1; i >= 0; i--) {
+            if (writes.at(i).reply == reply) {
+                writes.removeAt(i);
+                m_count--;
+            }
+        }
+        if (writes.isEmpty()) {
+            it = m_pendingWrites.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+QList<ZWaveReply *> OpenZWaveWriteTracker::takeValue(quint64 valueId, qint64 now, bool success)
+{
+    QList<ZWaveReply*> replies;
+    if (m_pendingWrites.isEmpty()) {
+        return replies;
+    }
+    foreach (const PendingWrite &write, m_pendingWrites.take(valueId)) {
+        if (success) {
+            recordLatency(write.nodeId, now - write.started);
+        }
+        replies.append(write.reply);
+        m_count--;
+    }
+    return replies;
+}
+
+QList<ZWaveReply *> OpenZWaveWriteTracker::takeNode(quint8 nodeId, qint64 now, bool success)
+{
+    QList<ZWaveReply*> replies;
+    QHash<quint64, QList<PendingWrite> >::iterator it = m_pendingWrites.begin();
+    while (it != m_pendingWrites.end()) {
+        QList<PendingWrite> &writes = it.value();
+        for (int i = writes.count() - 1; i >= 0; i--) {
+            if (writes.at(i).nodeId == nodeId) {
+                if (success) {
+                    recordLatency(nodeId, now - writes.at(i).started);
+                }
+                replies.prepend(writes.takeAt(i).reply);
+                m_count--;
+            }
+        }
+        if (writes.isEmpty()) {
+            it = m_pendingWrites.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return replies;
+}
+
+QList<ZWaveReply *> OpenZWaveWriteTracker::takeCompletedMessage(quint8 nodeId, qint64 now)
+{
+    QList<ZWaveReply*> replies;
+    QHash<quint64, QList<PendingWrite> >::iterator it = m_pendingWrites.begin();
+    while (it != m_pendingWrites.end()) {
+        QList<PendingWrite> &writes = it.value();
+        for (int i = writes.count() - 1; i >= 0; i--) {
+            PendingWrite &write = writes[i];
+            if (write.messagesAhead > 0) {
+                write.messagesAhead--;
+            } else if (write.messagesAhead == 0 && write.nodeId == nodeId) {
+                recordLatency(nodeId, now - write.started);
+                replies.prepend(writes.takeAt(i).reply);
+                m_count--;
+            }
+        }
+        if (writes.isEmpty()) {
+            it = m_pendingWrites.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return replies;
+}
+
+QList<ZWaveReply *> OpenZWaveWriteTracker::takeAll()
+{
+    QList<ZWaveReply*> replies;
+    foreach (const QList<PendingWrite> &writes, m_pendingWrites) {
+        foreach (const PendingWrite &write, writes) {
+            replies.append(write.reply);
+        }
+    }
+    m_pendingWrites.clear();
+    m_count = 0;
+    return replies;
+}
+
+bool OpenZWaveWriteTracker::isEmpty() const
+{
+    return m_count == 0;
+}
+
+int OpenZWaveWriteTracker::count() const
+{
+    return m_count;
+}
+
+OpenZWaveWriteTracker::Latency OpenZWaveWriteTracker::latency(quint8 nodeId) const
+{
+    return m_latencies.value(nodeId);
+}
+
+void OpenZWaveWriteTracker::recordLatency(quint8 nodeId, qint64 latency)
+{
+    Latency &entry = m_latencies[nodeId];
+    entry.count++;
+    entry.last = latency;
+    entry.max = qMax(entry.max, latency);
+    entry.total += latency;
+}
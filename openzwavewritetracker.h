@@ -0,0 +1,84 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+*
+* Copyright (C) 2013 - 2024, nymea GmbH
+* Copyright (C) 2024 - 2025, chargebyte austria GmbH
+*
+* This file is part of nymea-zwave-plugin-openzwave.
+*
+* nymea-zwave-plugin-openzwave is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* nymea-zwave-plugin-openzwave is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with nymea-zwave-plugin-openzwave. If not, see <https://www.gnu.org/licenses/>.
+*
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef OPENZWAVEWRITETRACKER_H
+#define OPENZWAVEWRITETRACKER_H
+
+#include <hardware/zwave/zwavereply.h>
+
+#include <QHash>
+#include <QList>
+
+// Keeps track of writes waiting for the device to confirm them, and of the round trip latency per node.
+class OpenZWaveWriteTracker
+{
+public:
+    struct Latency
+    {
+        quint32 count = 0;
+        qint64 last = 0;
+        qint64 max = 0;
+        qint64 total = 0;
+
+        qint64 average() const { return count > 0 ? total / count : 0; }
+    };
+
+    // Writes held back for a sleeping node are added as NotSent and marked sent() once they are flushed
+    static const int NotSent = -1;
+
+    // messagesAhead is the number of messages OpenZWave had queued before the write
+    void add(quint8 nodeId, quint64 valueId, ZWaveReply *reply, qint64 now, int messagesAhead);
+    void sent(quint64 valueId, int messagesAhead);
+    void remove(ZWaveReply *reply);
+
+    // Take the replies of completed writes. Successful writes are accounted in the node latency.
+    QList<ZWaveReply*> takeValue(quint64 valueId, qint64 now, bool success);
+    QList<ZWaveReply*> takeNode(quint8 nodeId, qint64 now, bool success);
+    QList<ZWaveReply*> takeAll();
+
+    // OpenZWave completed a message to the node. Only writes without messages ahead of them any more can
+    // be the completed one, all others move up by one message.
+    QList<ZWaveReply*> takeCompletedMessage(quint8 nodeId, qint64 now);
+
+    bool isEmpty() const;
+    int count() const;
+    Latency latency(quint8 nodeId) const;
+
+private:
+    struct PendingWrite
+    {
+        quint8 nodeId;
+        ZWaveReply *reply;
+        qint64 started;
+        int messagesAhead;
+    };
+
+    void recordLatency(quint8 nodeId, qint64 latency);
+
+    QHash<quint64, QList<PendingWrite> > m_pendingWrites;
+    QHash<quint8, Latency> m_latencies;
+    int m_count = 0;
+};
+
+#endif // OPENZWAVEWRITETRACKER_H
@@ -0,0 +1,404 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+*
+* Copyright (C) 2013 - 2024, nymea GmbH
+* Copyright (C) 2024 - 2025, chargebyte austria GmbH
+*
+* This file is part of nymea-zwave-plugin-openzwave.
+*
+* nymea-zwave-plugin-openzwave is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* nymea-zwave-plugin-openzwave is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with nymea-zwave-plugin-openzwave. If not, see <https://www.gnu.org/licenses/>.
+*
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "openzwavebackend.h"
+#include "openzwavestub.h"
+
+#include <QtTest>
+#include <QElapsedTimer>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+
+#include <functional>
+
+// Drives the backend with notifications from the OpenZWave stub. Values change with every notification,
+// so each one gets read and emitted like on a real network.
+class BenchmarkOpenZWaveBackend : public QObject
+{
+    Q_OBJECT
+
+public slots:
+    // Target of the name based dispatch, see nameDispatchCallback()
+    void onValueChanged(quint32 homeId, quint8 nodeId, quint64 id, ZWaveValue::Genre genre, ZWaveValue::CommandClass commandClass, quint8 instance, quint16 index, ZWaveValue::Type type);
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void notificationThroughput_data();
+    void notificationThroughput();
+
+    void readValue_data();
+    void readValue();
+
+    void nodeGetters_data();
+    void nodeGetters();
+
+    void dispatchCost_data();
+    void dispatchCost();
+
+    void twoControllerStartup_data();
+    void twoControllerStartup();
+
+private:
+    static void nameDispatchCallback(const OpenZWave::Notification *notification, void *context);
+    static OpenZWave::ValueID valueId(OpenZWave::ValueID::ValueType type, quint8 commandClass, quint16 index);
+    bool processEventsUntil(std::function<bool()> condition, int timeout = 30000);
+
+    // Keeps the snapshots and OpenZWave files away from the real storage path
+    QTemporaryDir m_storageDir;
+    OpenZWaveBackend *m_backend = nullptr;
+    QUuid m_networkUuid;
+    QList<OpenZWave::ValueID> m_valueIds;
+    quint64 m_valueChanges = 0;
+};
+
+static const char *ControllerPort = "/dev/ttyStub0";
+static const quint32 HomeId = 0xc0ffee01;
+static const quint8 NodeId = 2;
+
+OpenZWave::ValueID BenchmarkOpenZWaveBackend::valueId(OpenZWave::ValueID::ValueType type, quint8 commandClass, quint16 index)
+{
+    return OpenZWave::ValueID(HomeId, NodeId, OpenZWave::ValueID::ValueGenre_User, commandClass, 1, index, type);
+}
+
+bool BenchmarkOpenZWaveBackend::processEventsUntil(std::function<bool()> condition, int timeout)
+{
+    QElapsedTimer timer;
+    timer.start();
+    while (!condition()) {
+        if (timer.elapsed() > timeout) {
+            return false;
+        }
+        QCoreApplication::processEvents();
+    }
+    return true;
+}
+
+void BenchmarkOpenZWaveBackend::onValueChanged(quint32 homeId, quint8 nodeId, quint64 id, ZWaveValue::Genre genre, ZWaveValue::CommandClass commandClass, quint8 instance, quint16 index, ZWaveValue::Type type)
+{
+    m_backend->onValueChanged(homeId, nodeId, id, genre, commandClass, instance, index, type);
+}
+
+// How the callback dispatched notifications before the queue and the typed handler table: a slot looked up
+// by name and the arguments boxed for a queued call, once per notification
+void BenchmarkOpenZWaveBackend::nameDispatchCallback(const OpenZWave::Notification *notification, void *context)
+{
+    BenchmarkOpenZWaveBackend *self = static_cast<BenchmarkOpenZWaveBackend*>(context);
+    OpenZWave::ValueID valueId = notification->GetValueID();
+    QMetaObject::invokeMethod(self, "onValueChanged",
+                              Q_ARG(quint32, notification->GetHomeId()),
+                              Q_ARG(quint8, notification->GetNodeId()),
+                              Q_ARG(quint64, valueId.GetId()),
+                              Q_ARG(ZWaveValue::Genre, static_cast<ZWaveValue::Genre>(valueId.GetGenre())),
+                              Q_ARG(ZWaveValue::CommandClass, static_cast<ZWaveValue::CommandClass>(valueId.GetCommandClassId())),
+                              Q_ARG(quint8, valueId.GetInstance()),
+                              Q_ARG(quint16, valueId.GetIndex()),
+                              Q_ARG(ZWaveValue::Type, static_cast<ZWaveValue::Type>(valueId.GetType()))
+                              );
+}
+
+void BenchmarkOpenZWaveBackend::initTestCase()
+{
+    qRegisterMetaType<ZWaveValue::Genre>();
+    qRegisterMetaType<ZWaveValue::CommandClass>();
+    qRegisterMetaType<ZWaveValue::Type>();
+
+    OpenZWaveStub::reset();
+    OpenZWaveStub::addController(ControllerPort, HomeId);
+    OpenZWaveStub::addNode(HomeId, NodeId, "Benchmark node");
+
+    m_valueIds << valueId(OpenZWave::ValueID::ValueType_Bool, 0x25, 0)
+               << valueId(OpenZWave::ValueID::ValueType_Byte, 0x26, 0)
+               << valueId(OpenZWave::ValueID::ValueType_Decimal, 0x31, 1)
+               << valueId(OpenZWave::ValueID::ValueType_Int, 0x70, 1)
+               << valueId(OpenZWave::ValueID::ValueType_Short, 0x70, 2)
+               << valueId(OpenZWave::ValueID::ValueType_List, 0x70, 3)
+               << valueId(OpenZWave::ValueID::ValueType_String, 0x72, 4);
+    foreach (const OpenZWave::ValueID &id, m_valueIds) {
+        if (id.GetType() == OpenZWave::ValueID::ValueType_List) {
+            OpenZWaveStub::addListValue(id, {"Off", "Low", "Medium", "High"}, {0, 1, 2, 3}, 1);
+        } else if (id.GetType() == OpenZWave::ValueID::ValueType_String) {
+            OpenZWaveStub::addStringValue(id, "Benchmark");
+        } else {
+            OpenZWaveStub::addValue(id, 1, true);
+        }
+    }
+
+    QVERIFY(m_storageDir.isValid());
+    m_backend = new OpenZWaveBackend(this);
+    m_backend->m_storagePath = m_storageDir.path() + "/";
+    m_networkUuid = QUuid::createUuid();
+    connect(m_backend, &ZWaveBackend::valueChanged, this, [this](){ m_valueChanges++; });
+
+    QSignalSpy startedSpy(m_backend, &ZWaveBackend::networkStarted);
+    QVERIFY(m_backend->startNetwork(m_networkUuid, ControllerPort, "0102030405060708090a0b0c0d0e0f10"));
+    QVERIFY(startedSpy.count() > 0 || startedSpy.wait());
+
+    QSignalSpy valueAddedSpy(m_backend, &ZWaveBackend::valueAdded);
+    OpenZWave::Notification nodeAdded(OpenZWave::Notification::Type_NodeAdded);
+    nodeAdded.SetHomeAndNodeIds(HomeId, NodeId);
+    OpenZWaveStub::post(nodeAdded);
+    foreach (const OpenZWave::ValueID &id, m_valueIds) {
+        OpenZWave::Notification valueAdded(OpenZWave::Notification::Type_ValueAdded);
+        valueAdded.SetValueId(id);
+        OpenZWaveStub::post(valueAdded);
+    }
+    QTRY_COMPARE(valueAddedSpy.count(), m_valueIds.count());
+}
+
+void BenchmarkOpenZWaveBackend::cleanupTestCase()
+{
+    m_backend->stopNetwork(m_networkUuid);
+    delete m_backend;
+    m_backend = nullptr;
+}
+
+void BenchmarkOpenZWaveBackend::notificationThroughput_data()
+{
+    QTest::addColumn<int>("type");
+    QTest::addColumn<int>("code");
+    QTest::addColumn<int>("count");
+    QTest::addColumn<int>("rate");
+
+    QTest::newRow("ValueChanged") << static_cast<int>(OpenZWave::Notification::Type_ValueChanged) << 0 << 10000 << 0;
+    QTest::newRow("ValueRefreshed") << static_cast<int>(OpenZWave::Notification::Type_ValueRefreshed) << 0 << 10000 << 0;
+    // Dropped in the callback while no asynchronous write is pending
+    QTest::newRow("MsgComplete") << static_cast<int>(OpenZWave::Notification::Type_Notification) << static_cast<int>(OpenZWave::Notification::Code_MsgComplete) << 10000 << 0;
+    // A busy network, the dispatch latency is what matters here
+    QTest::newRow("ValueChanged 1000/s") << static_cast<int>(OpenZWave::Notification::Type_ValueChanged) << 0 << 1000 << 1000;
+}
+
+void BenchmarkOpenZWaveBackend::notificationThroughput()
+{
+    QFETCH(int, type);
+    QFETCH(int, code);
+    QFETCH(int, count);
+    QFETCH(int, rate);
+
+    OpenZWave::Notification notification(static_cast<OpenZWave::Notification::NotificationType>(type));
+    if (type == OpenZWave::Notification::Type_Notification) {
+        notification.SetHomeAndNodeIds(HomeId, NodeId);
+        notification.SetNotification(static_cast<quint8>(code));
+    } else {
+        notification.SetValueId(m_valueIds.at(1));
+    }
+    bool emitsValueChanged = type == OpenZWave::Notification::Type_ValueChanged || type == OpenZWave::Notification::Type_ValueRefreshed;
+
+    m_backend->resetDispatchStatistics();
+    qint64 total = 0;
+    quint64 notifications = 0;
+    QBENCHMARK {
+        quint64 expectedChanges = m_valueChanges + count;
+        QElapsedTimer timer;
+        timer.start();
+        OpenZWaveStub::generate(notification, count, rate);
+        if (emitsValueChanged) {
+            QVERIFY(processEventsUntil([this, expectedChanges](){ return m_valueChanges >= expectedChanges; }));
+        } else {
+            QVERIFY(OpenZWaveStub::waitForIdle());
+            QCoreApplication::processEvents();
+        }
+        total += timer.nsecsElapsed();
+        notifications += count;
+    }
+
+    const OpenZWaveDispatchStatistics statistics = m_backend->dispatchStatistics(m_networkUuid);
+    qInfo() << "Notifications/s:" << (total > 0 ? notifications * 1000000000 / total : 0);
+    qInfo() << "Queue delay:" << statistics.queueDelay().toString();
+    qInfo() << "Handler time:" << statistics.handlerTime().toString();
+}
+
+void BenchmarkOpenZWaveBackend::readValue_data()
+{
+    QTest::addColumn<int>("index");
+    QTest::addColumn<bool>("cached");
+
+    // In the order of m_valueIds
+    QStringList types = {"Bool", "Byte", "Decimal", "Int", "Short", "List", "String"};
+    for (int i = 0; i < types.count(); i++) {
+        QTest::newRow(qPrintable(types.at(i))) << i << true;
+        // Without metadata also the help text, units, limits and list items are read
+        QTest::newRow(qPrintable(types.at(i) + " without metadata")) << i << false;
+    }
+}
+
+void BenchmarkOpenZWaveBackend::readValue()
+{
+    QFETCH(int, index);
+    QFETCH(bool, cached);
+
+    OpenZWave::ValueID id = m_valueIds.at(index);
+    OpenZWaveNetwork *network = m_backend->m_networks.value(m_networkUuid);
+    QVERIFY(network);
+
+    ZWaveValue value;
+    QBENCHMARK {
+        if (!cached) {
+            network->metadata.remove(id.GetId());
+        }
+        value = m_backend->readValue(network, id.GetNodeId(), id.GetId(),
+                                     static_cast<ZWaveValue::Genre>(id.GetGenre()),
+                                     static_cast<ZWaveValue::CommandClass>(id.GetCommandClassId()),
+                                     id.GetInstance(),
+                                     id.GetIndex(),
+                                     static_cast<ZWaveValue::Type>(id.GetType()));
+    }
+    QCOMPARE(value.id(), id.GetId());
+}
+
+void BenchmarkOpenZWaveBackend::nodeGetters_data()
+{
+    QTest::addColumn<bool>("cached");
+
+    QTest::newRow("cached") << true;
+    // Like after a NodeNaming or NodeProtocolInfo notification
+    QTest::newRow("invalidated") << false;
+}
+
+void BenchmarkOpenZWaveBackend::nodeGetters()
+{
+    QFETCH(bool, cached);
+
+    OpenZWaveNetwork *network = m_backend->m_networks.value(m_networkUuid);
+    QVERIFY(network);
+
+    // What the nymea core reads when it sets up a node
+    QString name;
+    QBENCHMARK {
+        if (!cached) {
+            network->invalidateNodeInfo(NodeId);
+        }
+        name = m_backend->nodeName(m_networkUuid, NodeId);
+        m_backend->nodeType(m_networkUuid, NodeId);
+        m_backend->nodeDeviceType(m_networkUuid, NodeId);
+        m_backend->nodeRole(m_networkUuid, NodeId);
+        m_backend->nodeSecurityMode(m_networkUuid, NodeId);
+        m_backend->nodeManufacturerId(m_networkUuid, NodeId);
+        m_backend->nodeManufacturerName(m_networkUuid, NodeId);
+        m_backend->nodeProductId(m_networkUuid, NodeId);
+        m_backend->nodeProductName(m_networkUuid, NodeId);
+        m_backend->nodeProductType(m_networkUuid, NodeId);
+        m_backend->nodeVersion(m_networkUuid, NodeId);
+        m_backend->nodeIsZWavePlus(m_networkUuid, NodeId);
+        m_backend->nodePlusDeviceType(m_networkUuid, NodeId);
+        m_backend->nodeIsSecureDevice(m_networkUuid, NodeId);
+        m_backend->nodeIsBeamingDevice(m_networkUuid, NodeId);
+    }
+    QCOMPARE(name, QString("Benchmark node"));
+}
+
+void BenchmarkOpenZWaveBackend::dispatchCost_data()
+{
+    QTest::addColumn<bool>("byName");
+
+    QTest::newRow("slot by name") << true;
+    QTest::newRow("handler table") << false;
+}
+
+void BenchmarkOpenZWaveBackend::dispatchCost()
+{
+    QFETCH(bool, byName);
+
+    // Both paths end in the same handler, so the difference is the cost of getting there
+    static const int Count = 10000;
+    OpenZWave::Manager *manager = OpenZWave::Manager::Get();
+    if (byName) {
+        manager->RemoveWatcher(OpenZWaveBackend::ozwCallback, m_backend);
+        manager->AddWatcher(nameDispatchCallback, this);
+    }
+
+    OpenZWave::Notification notification(OpenZWave::Notification::Type_ValueChanged);
+    notification.SetValueId(m_valueIds.at(1));
+
+    qint64 total = 0;
+    quint64 notifications = 0;
+    QBENCHMARK {
+        quint64 expectedChanges = m_valueChanges + Count;
+        QElapsedTimer timer;
+        timer.start();
+        OpenZWaveStub::generate(notification, Count);
+        QVERIFY(processEventsUntil([this, expectedChanges](){ return m_valueChanges >= expectedChanges; }));
+        total += timer.nsecsElapsed();
+        notifications += Count;
+    }
+
+    if (byName) {
+        manager->RemoveWatcher(nameDispatchCallback, this);
+        manager->AddWatcher(OpenZWaveBackend::ozwCallback, m_backend);
+    }
+    qInfo() << "ns per notification:" << (notifications > 0 ? total / static_cast<qint64>(notifications) : 0);
+}
+
+void BenchmarkOpenZWaveBackend::twoControllerStartup_data()
+{
+    QTest::addColumn<int>("firstReadyDelay");
+    QTest::addColumn<int>("secondReadyDelay");
+
+    QTest::newRow("ready in start order") << 100 << 200;
+    QTest::newRow("ready in reverse order") << 200 << 100;
+}
+
+void BenchmarkOpenZWaveBackend::twoControllerStartup()
+{
+    QFETCH(int, firstReadyDelay);
+    QFETCH(int, secondReadyDelay);
+
+    OpenZWaveStub::addController("/dev/ttyStub1", 0xc0ffee11, firstReadyDelay);
+    OpenZWaveStub::addController("/dev/ttyStub2", 0xc0ffee12, secondReadyDelay);
+
+    QBENCHMARK {
+        QUuid firstUuid = QUuid::createUuid();
+        QUuid secondUuid = QUuid::createUuid();
+        QSignalSpy startedSpy(m_backend, &ZWaveBackend::networkStarted);
+        QElapsedTimer timer;
+        timer.start();
+        QVERIFY(m_backend->startNetwork(firstUuid, "/dev/ttyStub1", "0102030405060708090a0b0c0d0e0f10"));
+        QVERIFY(m_backend->startNetwork(secondUuid, "/dev/ttyStub2", "0102030405060708090a0b0c0d0e0f10"));
+        QVERIFY(processEventsUntil([&startedSpy](){ return startedSpy.count() >= 2; }, firstReadyDelay + secondReadyDelay + 5000));
+        qint64 elapsed = timer.elapsed();
+
+        // The drivers start in parallel, so both are up after the longer delay, clearly before the sum of both
+        QVERIFY2(elapsed < qMax(firstReadyDelay, secondReadyDelay) + qMin(firstReadyDelay, secondReadyDelay) / 2,
+                 qPrintable(QString("Both networks took %1 ms to start").arg(elapsed)));
+
+        // Each network got the home id of its own controller, whichever came up first
+        QSet<QUuid> startedUuids;
+        startedUuids << startedSpy.at(0).at(0).toUuid() << startedSpy.at(1).at(0).toUuid();
+        QCOMPARE(startedUuids, QSet<QUuid>() << firstUuid << secondUuid);
+        QCOMPARE(m_backend->homeId(firstUuid), 0xc0ffee11u);
+        QCOMPARE(m_backend->homeId(secondUuid), 0xc0ffee12u);
+
+        m_backend->stopNetwork(firstUuid);
+        m_backend->stopNetwork(secondUuid);
+        QVERIFY(OpenZWaveStub::waitForIdle());
+        QCoreApplication::processEvents();
+    }
+
+    OpenZWaveBackend::StartupTimes times = m_backend->warmStartTimes();
+    qInfo() << "Driver ready after" << times.average() << "ms on average, at most" << times.max << "ms";
+}
+
+QTEST_MAIN(BenchmarkOpenZWaveBackend)
+#include "benchmarkopenzwavebackend.moc"
@@ -0,0 +1,29 @@
+QT -= gui
+QT += testlib
+
+TARGET = benchmarkopenzwavebackend
+TEMPLATE = app
+CONFIG += console testcase no_testcase_installs
+CONFIG -= app_bundle
+
+greaterThan(QT_MAJOR_VERSION, 5) {
+    CONFIG *= c++17
+    QMAKE_LFLAGS *= -std=c++17
+    QMAKE_CXXFLAGS *= -std=c++17
+} else {
+    CONFIG *= c++11
+    QMAKE_LFLAGS *= -std=c++11
+    QMAKE_CXXFLAGS *= -std=c++11
+    DEFINES += QT_DISABLE_DEPRECATED_UP_TO=0x050F00
+}
+
+CONFIG += link_pkgconfig thread
+PKGCONFIG += nymea
+
+# The backend is built against the stub instead of libopenzwave
+DEFINES += OZW_16
+include(../openzwavestub/openzwavestub.pri)
+include(../../openzwavebackend.pri)
+
+SOURCES += \
+    benchmarkopenzwavebackend.cpp
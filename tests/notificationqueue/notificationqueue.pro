@@ -0,0 +1,27 @@
+QT -= gui
+QT += testlib
+
+TARGET = testopenzwavenotificationqueue
+TEMPLATE = app
+CONFIG += console testcase no_testcase_installs thread
+CONFIG -= app_bundle
+
+greaterThan(QT_MAJOR_VERSION, 5) {
+    CONFIG *= c++17
+    QMAKE_LFLAGS *= -std=c++17
+    QMAKE_CXXFLAGS *= -std=c++17
+} else {
+    CONFIG *= c++11
+    QMAKE_LFLAGS *= -std=c++11
+    QMAKE_CXXFLAGS *= -std=c++11
+    DEFINES += QT_DISABLE_DEPRECATED_UP_TO=0x050F00
+}
+
+INCLUDEPATH += $$PWD/../..
+
+SOURCES += \
+    $$PWD/../../openzwavenotificationqueue.cpp \
+    testopenzwavenotificationqueue.cpp
+
+HEADERS += \
+    $$PWD/../../openzwavenotificationqueue.h
@@ -0,0 +1,81 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+*
+* Copyright (C) 2013 - 2024, nymea GmbH
+* Copyright (C) 2024 - 2025, chargebyte austria GmbH
+*
+* This file is part of nymea-zwave-plugin-openzwave.
+*
+* nymea-zwave-plugin-openzwave is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* nymea-zwave-plugin-openzwave is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with nymea-zwave-plugin-openzwave. If not, see <https://www.gnu.org/licenses/>.
+*
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "openzwavenotificationqueue.h"
+
+#include <QtTest>
+#include <QElapsedTimer>
+
+#include <thread>
+
+class TestOpenZWaveNotificationQueue : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void orderDuringOverflow();
+};
+
+void TestOpenZWaveNotificationQueue::orderDuringOverflow()
+{
+    static const quint64 Count = 200000;
+    QScopedPointer<OpenZWaveNotificationQueue> queue(new OpenZWaveNotificationQueue());
+
+    std::thread producer([&queue](){
+        for (quint64 i = 0; i < Count; i++) {
+            OpenZWaveNotificationRecord record;
+            record.valueId = i;
+            queue->enqueue(record);
+            // Pauses now and then, so drains also start with a partly filled ring which then runs full
+            if (i % 256 == 0) {
+                QThread::usleep(20);
+            }
+        }
+    });
+
+    quint64 next = 0;
+    quint64 firstOutOfOrder = Count;
+    QElapsedTimer timer;
+    timer.start();
+    while (next < Count && timer.elapsed() < 30000) {
+        queue->drain([&next, &firstOutOfOrder](const OpenZWaveNotificationRecord &record) {
+            if (record.valueId != next && firstOutOfOrder == Count) {
+                firstOutOfOrder = next;
+            }
+            next++;
+            // A slower consumer, so the producer runs the ring full and spills
+            if (next % 64 == 0) {
+                QThread::usleep(20);
+            }
+        });
+    }
+    producer.join();
+
+    QCOMPARE(next, Count);
+    QCOMPARE(firstOutOfOrder, Count);
+    QVERIFY(queue->statistics().overflows > 0);
+}
+
+QTEST_MAIN(TestOpenZWaveNotificationQueue)
+#include "testopenzwavenotificationqueue.moc"
@@ -0,0 +1,70 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+*
+* Copyright (C) 2013 - 2024, nymea GmbH
+* Copyright (C) 2024 - 2025, chargebyte austria GmbH
+*
+* This file is part of nymea-zwave-plugin-openzwave.
+*
+* nymea-zwave-plugin-openzwave is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* nymea-zwave-plugin-openzwave is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with nymea-zwave-plugin-openzwave. If not, see <https://www.gnu.org/licenses/>.
+*
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef OPENZWAVESTUB_DRIVER_H
+#define OPENZWAVESTUB_DRIVER_H
+
+#include "Defs.h"
+
+namespace OpenZWave {
+
+class Driver
+{
+public:
+    enum ControllerInterface {
+        ControllerInterface_Unknown = 0,
+        ControllerInterface_Serial,
+        ControllerInterface_Hid
+    };
+
+    struct DriverData
+    {
+        uint32 m_SOFCnt = 0;
+        uint32 m_ACKWaiting = 0;
+        uint32 m_readAborts = 0;
+        uint32 m_badChecksum = 0;
+        uint32 m_readCnt = 0;
+        uint32 m_writeCnt = 0;
+        uint32 m_CANCnt = 0;
+        uint32 m_NAKCnt = 0;
+        uint32 m_ACKCnt = 0;
+        uint32 m_OOFCnt = 0;
+        uint32 m_dropped = 0;
+        uint32 m_retries = 0;
+        uint32 m_callbacks = 0;
+        uint32 m_badroutes = 0;
+        uint32 m_noack = 0;
+        uint32 m_netbusy = 0;
+        uint32 m_notidle = 0;
+        uint32 m_txverified = 0;
+        uint32 m_nondelivery = 0;
+        uint32 m_routedbusy = 0;
+        uint32 m_broadcastReadCnt = 0;
+        uint32 m_broadcastWriteCnt = 0;
+    };
+};
+
+}
+
+#endif // OPENZWAVESTUB_DRIVER_H
@@ -0,0 +1,129 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+*
+* Copyright (C) 2013 - 2024, nymea GmbH
+* Copyright (C) 2024 - 2025, chargebyte austria GmbH
+*
+* This file is part of nymea-zwave-plugin-openzwave.
+*
+* nymea-zwave-plugin-openzwave is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* nymea-zwave-plugin-openzwave is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with nymea-zwave-plugin-openzwave. If not, see <https://www.gnu.org/licenses/>.
+*
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef OPENZWAVESTUB_MANAGER_H
+#define OPENZWAVESTUB_MANAGER_H
+
+#include "Defs.h"
+#include "ValueID.h"
+#include "Notification.h"
+#include "Driver.h"
+#include "Node.h"
+#include "OZWException.h"
+#include "platform/Log.h"
+
+namespace OpenZWave {
+
+// Answers from the network set up with the OpenZWaveStub functions. Notifications are delivered to the
+// watchers on a notification thread of its own, like OpenZWave does.
+class Manager
+{
+public:
+    typedef void (*pfnOnNotification_t)(const Notification *notification, void *context);
+
+    static Manager *Create();
+    static Manager *Get();
+    static void Destroy();
+
+    bool AddWatcher(pfnOnNotification_t watcher, void *context);
+    bool RemoveWatcher(pfnOnNotification_t watcher, void *context);
+
+    bool AddDriver(const std::string &controllerPath, const Driver::ControllerInterface &interface = Driver::ControllerInterface_Serial);
+    bool RemoveDriver(const std::string &controllerPath);
+
+    uint8 GetControllerNodeId(uint32 homeId);
+    bool IsPrimaryController(uint32 homeId);
+    bool IsStaticUpdateController(uint32 homeId);
+    bool IsBridgeController(uint32 homeId);
+    bool HasExtendedTxStatus(uint32 homeId);
+    std::string GetControllerPath(uint32 homeId);
+    int32 GetSendQueueCount(uint32 homeId);
+    void GetDriverStatistics(uint32 homeId, Driver::DriverData *data);
+    void GetNodeStatistics(uint32 homeId, uint8 nodeId, Node::NodeData *data);
+
+    void ResetController(uint32 homeId);
+    bool AddNode(uint32 homeId, bool doSecurity = true);
+    bool RemoveNode(uint32 homeId);
+    bool RemoveFailedNode(uint32 homeId, uint8 nodeId);
+    bool CancelControllerCommand(uint32 homeId);
+    void HealNetworkNode(uint32 homeId, uint8 nodeId, bool doRR);
+
+    void SetPollInterval(int32 milliseconds, bool intervalBetweenPolls);
+    bool IsPolled(const ValueID &valueId);
+    void SetPollIntensity(const ValueID &valueId, uint8 intensity);
+    uint8 GetPollIntensity(const ValueID &valueId);
+
+    bool IsNodeListeningDevice(uint32 homeId, uint8 nodeId);
+    bool IsNodeFrequentListeningDevice(uint32 homeId, uint8 nodeId);
+    bool IsNodeBeamingDevice(uint32 homeId, uint8 nodeId);
+    bool IsNodeAwake(uint32 homeId, uint8 nodeId);
+    bool IsNodeFailed(uint32 homeId, uint8 nodeId);
+    bool IsNodeZWavePlus(uint32 homeId, uint8 nodeId);
+    uint8 GetNodeBasic(uint32 homeId, uint8 nodeId);
+    uint16 GetNodeDeviceType(uint32 homeId, uint8 nodeId);
+    uint8 GetNodeRole(uint32 homeId, uint8 nodeId);
+    uint8 GetNodePlusType(uint32 homeId, uint8 nodeId);
+    uint8 GetNodeSecurity(uint32 homeId, uint8 nodeId);
+    uint8 GetNodeVersion(uint32 homeId, uint8 nodeId);
+    std::string GetNodeName(uint32 homeId, uint8 nodeId);
+    std::string GetNodeManufacturerName(uint32 homeId, uint8 nodeId);
+    std::string GetNodeProductName(uint32 homeId, uint8 nodeId);
+    std::string GetNodeManufacturerId(uint32 homeId, uint8 nodeId);
+    std::string GetNodeProductType(uint32 homeId, uint8 nodeId);
+    std::string GetNodeProductId(uint32 homeId, uint8 nodeId);
+
+    std::string GetValueHelp(const ValueID &valueId);
+    std::string GetValueUnits(const ValueID &valueId);
+    int32 GetValueMin(const ValueID &valueId);
+    int32 GetValueMax(const ValueID &valueId);
+    bool GetValueAsBool(const ValueID &valueId, bool *value);
+    bool GetValueAsByte(const ValueID &valueId, uint8 *value);
+    bool GetValueAsFloat(const ValueID &valueId, float *value);
+    bool GetValueAsInt(const ValueID &valueId, int32 *value);
+    bool GetValueAsShort(const ValueID &valueId, int16 *value);
+    bool GetValueAsString(const ValueID &valueId, std::string *value);
+    bool GetValueListSelection(const ValueID &valueId, std::string *value);
+    bool GetValueListSelection(const ValueID &valueId, int32 *value);
+    bool GetValueListItems(const ValueID &valueId, std::vector<std::string> *items);
+    bool GetValueListValues(const ValueID &valueId, std::vector<int32> *values);
+
+    bool SetValue(const ValueID &valueId, bool value);
+    bool SetValue(const ValueID &valueId, uint8 value);
+    bool SetValue(const ValueID &valueId, float value);
+    bool SetValue(const ValueID &valueId, int32 value);
+    bool SetValue(const ValueID &valueId, int16 value);
+    bool SetValue(const ValueID &valueId, const std::string &value);
+    bool SetValueListSelection(const ValueID &valueId, const std::string &selectedItem);
+    bool PressButton(const ValueID &valueId);
+    bool ReleaseButton(const ValueID &valueId);
+    bool RefreshValue(const ValueID &valueId);
+
+private:
+    Manager() {}
+    ~Manager() {}
+};
+
+}
+
+#endif // OPENZWAVESTUB_MANAGER_H
@@ -0,0 +1,69 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+*
+* Copyright (C) 2013 - 2024, nymea GmbH
+* Copyright (C) 2024 - 2025, chargebyte austria GmbH
+*
+* This file is part of nymea-zwave-plugin-openzwave.
+*
+* nymea-zwave-plugin-openzwave is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* nymea-zwave-plugin-openzwave is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with nymea-zwave-plugin-openzwave. If not, see <https://www.gnu.org/licenses/>.
+*
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef OPENZWAVESTUB_NODE_H
+#define OPENZWAVESTUB_NODE_H
+
+#include "Defs.h"
+
+namespace OpenZWave {
+
+class Node
+{
+public:
+    struct NodeData
+    {
+        uint32 m_sentCnt = 0;
+        uint32 m_sentFailed = 0;
+        uint32 m_retries = 0;
+        uint32 m_receivedCnt = 0;
+        uint32 m_receivedDups = 0;
+        uint32 m_receivedUnsolicited = 0;
+        std::string m_sentTS;
+        std::string m_receivedTS;
+        uint32 m_lastRequestRTT = 0;
+        uint32 m_averageRequestRTT = 0;
+        uint32 m_lastResponseRTT = 0;
+        uint32 m_averageResponseRTT = 0;
+        uint8 m_quality = 0;
+        uint8 m_lastReceivedMessage[254] = {};
+        bool m_txStatusReportSupported = false;
+        uint16 m_txTime = 0;
+        uint8 m_hops = 0;
+        char m_rssi_1[8] = {};
+        char m_rssi_2[8] = {};
+        char m_rssi_3[8] = {};
+        char m_rssi_4[8] = {};
+        char m_rssi_5[8] = {};
+        uint8 m_ackChannel = 0;
+        uint8 m_lastTxChannel = 0;
+        uint8 m_routeTries = 0;
+        uint8 m_lastFailedLinkFrom = 0;
+        uint8 m_lastFailedLinkTo = 0;
+    };
+};
+
+}
+
+#endif // OPENZWAVESTUB_NODE_H
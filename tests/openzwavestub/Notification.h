@@ -0,0 +1,135 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+*
+* Copyright (C) 2013 - 2024, nymea GmbH
+* Copyright (C) 2024 - 2025, chargebyte austria GmbH
+*
+* This file is part of nymea-zwave-plugin-openzwave.
+*
+* nymea-zwave-plugin-openzwave is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* nymea-zwave-plugin-openzwave is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with nymea-zwave-plugin-openzwave. If not, see <https://www.gnu.org/licenses/>.
+*
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef OPENZWAVESTUB_NOTIFICATION_H
+#define OPENZWAVESTUB_NOTIFICATION_H
+
+#include "Defs.h"
+#include "ValueID.h"
+
+namespace OpenZWave {
+
+// Unlike the real one it can be constructed and filled in, to be posted with OpenZWaveStub::post()
+class Notification
+{
+public:
+    enum NotificationType {
+        Type_ValueAdded = 0,
+        Type_ValueRemoved,
+        Type_ValueChanged,
+        Type_ValueRefreshed,
+        Type_Group,
+        Type_NodeNew,
+        Type_NodeAdded,
+        Type_NodeRemoved,
+        Type_NodeProtocolInfo,
+        Type_NodeNaming,
+        Type_NodeEvent,
+        Type_PollingDisabled,
+        Type_PollingEnabled,
+        Type_SceneEvent,
+        Type_CreateButton,
+        Type_DeleteButton,
+        Type_ButtonOn,
+        Type_ButtonOff,
+        Type_DriverReady,
+        Type_DriverFailed,
+        Type_DriverReset,
+        Type_EssentialNodeQueriesComplete,
+        Type_NodeQueriesComplete,
+        Type_AwakeNodesQueried,
+        Type_AllNodesQueriedSomeDead,
+        Type_AllNodesQueried,
+        Type_Notification,
+        Type_DriverRemoved,
+        Type_ControllerCommand,
+        Type_NodeReset,
+        Type_UserAlerts,
+        Type_ManufacturerSpecificDBReady
+    };
+
+    enum NotificationCode {
+        Code_MsgComplete = 0,
+        Code_Timeout,
+        Code_NoOperation,
+        Code_Awake,
+        Code_Sleep,
+        Code_Dead,
+        Code_Alive
+    };
+
+    enum UserAlertNotification {
+        Alert_None,
+        Alert_ConfigOutOfDate,
+        Alert_MFSOutOfDate,
+        Alert_ConfigFileDownloadFailed,
+        Alert_DNSError,
+        Alert_NodeReloadRequired,
+        Alert_UnsupportedController,
+        Alert_ApplicationStatus_Retry,
+        Alert_ApplicationStatus_Queued,
+        Alert_ApplicationStatus_Rejected
+    };
+
+    explicit Notification(NotificationType type = Type_ValueChanged):
+        m_type(type)
+    {
+    }
+
+    NotificationType GetType() const { return m_type; }
+    uint32 GetHomeId() const { return m_homeId; }
+    uint8 GetNodeId() const { return m_nodeId; }
+    const ValueID &GetValueID() const { return m_valueId; }
+    uint8 GetEvent() const { return m_event; }
+    uint8 GetNotification() const { return m_notification; }
+    uint8 GetCommand() const { return m_command; }
+    std::string GetComPort() const { return m_comPort; }
+    UserAlertNotification GetUserAlertType() const { return m_userAlertType; }
+    std::string GetAsString() const { return m_string; }
+
+    void SetHomeAndNodeIds(uint32 homeId, uint8 nodeId) { m_homeId = homeId; m_nodeId = nodeId; }
+    void SetValueId(const ValueID &valueId) { m_valueId = valueId; m_homeId = valueId.GetHomeId(); m_nodeId = valueId.GetNodeId(); }
+    void SetEvent(uint8 event) { m_event = event; }
+    void SetNotification(uint8 notification) { m_notification = notification; }
+    void SetCommand(uint8 command) { m_command = command; }
+    void SetComPort(const std::string &comPort) { m_comPort = comPort; }
+    void SetUserAlertType(UserAlertNotification type) { m_userAlertType = type; }
+    void SetString(const std::string &string) { m_string = string; }
+
+private:
+    NotificationType m_type;
+    uint32 m_homeId = 0;
+    uint8 m_nodeId = 0;
+    ValueID m_valueId;
+    uint8 m_event = 0;
+    uint8 m_notification = 0;
+    uint8 m_command = 0;
+    std::string m_comPort;
+    UserAlertNotification m_userAlertType = Alert_None;
+    std::string m_string;
+};
+
+}
+
+#endif // OPENZWAVESTUB_NOTIFICATION_H
@@ -0,0 +1,60 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+*
+* Copyright (C) 2013 - 2024, nymea GmbH
+* Copyright (C) 2024 - 2025, chargebyte austria GmbH
+*
+* This file is part of nymea-zwave-plugin-openzwave.
+*
+* nymea-zwave-plugin-openzwave is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* nymea-zwave-plugin-openzwave is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with nymea-zwave-plugin-openzwave. If not, see <https://www.gnu.org/licenses/>.
+*
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef OPENZWAVESTUB_OZWEXCEPTION_H
+#define OPENZWAVESTUB_OZWEXCEPTION_H
+
+#include <stdexcept>
+#include <string>
+
+namespace OpenZWave {
+
+class OZWException : public std::runtime_error
+{
+public:
+    enum ExceptionType {
+        OZWEXCEPTION_OPTIONS,
+        OZWEXCEPTION_CONFIG,
+        OZWEXCEPTION_INVALID_HOMEID = 100,
+        OZWEXCEPTION_INVALID_VALUEID,
+        OZWEXCEPTION_CANNOT_CONVERT_VALUEID,
+        OZWEXCEPTION_SECURITY_FAILED,
+        OZWEXCEPTION_INVALID_NODEID
+    };
+
+    OZWException(ExceptionType type, const std::string &message):
+        std::runtime_error(message),
+        m_type(type)
+    {
+    }
+
+    ExceptionType GetType() const { return m_type; }
+
+private:
+    ExceptionType m_type;
+};
+
+}
+
+#endif // OPENZWAVESTUB_OZWEXCEPTION_H
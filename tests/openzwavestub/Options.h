@@ -0,0 +1,59 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+*
+* Copyright (C) 2013 - 2024, nymea GmbH
+* Copyright (C) 2024 - 2025, chargebyte austria GmbH
+*
+* This file is part of nymea-zwave-plugin-openzwave.
+*
+* nymea-zwave-plugin-openzwave is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* nymea-zwave-plugin-openzwave is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with nymea-zwave-plugin-openzwave. If not, see <https://www.gnu.org/licenses/>.
+*
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef OPENZWAVESTUB_OPTIONS_H
+#define OPENZWAVESTUB_OPTIONS_H
+
+#include "Defs.h"
+
+#include <map>
+
+namespace OpenZWave {
+
+// Keeps the options as strings, see OpenZWaveStub::option()
+class Options
+{
+public:
+    static Options *Create(const std::string &configPath, const std::string &userPath, const std::string &commandLine);
+    static bool Destroy();
+    static Options *Get();
+
+    bool Lock();
+    bool AddOptionBool(const std::string &name, bool value);
+    bool AddOptionInt(const std::string &name, int32 value);
+    bool AddOptionString(const std::string &name, const std::string &value, bool append);
+
+    std::string GetOption(const std::string &name) const;
+    bool AreLocked() const { return m_locked; }
+
+private:
+    Options() {}
+
+    std::map<std::string, std::string> m_options;
+    bool m_locked = false;
+};
+
+}
+
+#endif // OPENZWAVESTUB_OPTIONS_H
@@ -0,0 +1,95 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+*
+* Copyright (C) 2013 - 2024, nymea GmbH
+* Copyright (C) 2024 - 2025, chargebyte austria GmbH
+*
+* This file is part of nymea-zwave-plugin-openzwave.
+*
+* nymea-zwave-plugin-openzwave is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* nymea-zwave-plugin-openzwave is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with nymea-zwave-plugin-openzwave. If not, see <https://www.gnu.org/licenses/>.
+*
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef OPENZWAVESTUB_VALUEID_H
+#define OPENZWAVESTUB_VALUEID_H
+
+#include "Defs.h"
+
+namespace OpenZWave {
+
+// The fields are packed into the 64 bit id, so a ValueID can be rebuilt from the home id and the id alone
+class ValueID
+{
+public:
+    enum ValueGenre {
+        ValueGenre_Basic = 0,
+        ValueGenre_User,
+        ValueGenre_Config,
+        ValueGenre_System,
+        ValueGenre_Count
+    };
+
+    enum ValueType {
+        ValueType_Bool = 0,
+        ValueType_Byte,
+        ValueType_Decimal,
+        ValueType_Int,
+        ValueType_List,
+        ValueType_Schedule,
+        ValueType_Short,
+        ValueType_String,
+        ValueType_Button,
+        ValueType_Raw,
+        ValueType_BitSet,
+        ValueType_Max = ValueType_BitSet
+    };
+
+    ValueID() {}
+    ValueID(uint32 homeId, uint64 id):
+        m_homeId(homeId),
+        m_id(id)
+    {
+    }
+    ValueID(uint32 homeId, uint8 nodeId, ValueGenre genre, uint8 commandClassId, uint8 instance, uint16 index, ValueType type):
+        m_homeId(homeId),
+        m_id((static_cast<uint64>(nodeId) << 56)
+             | (static_cast<uint64>(genre & 0x03) << 54)
+             | (static_cast<uint64>(commandClassId) << 46)
+             | (static_cast<uint64>(instance) << 38)
+             | (static_cast<uint64>(index) << 22)
+             | static_cast<uint64>(type & 0x0f))
+    {
+    }
+
+    uint32 GetHomeId() const { return m_homeId; }
+    uint8 GetNodeId() const { return static_cast<uint8>(m_id >> 56); }
+    ValueGenre GetGenre() const { return static_cast<ValueGenre>((m_id >> 54) & 0x03); }
+    uint8 GetCommandClassId() const { return static_cast<uint8>(m_id >> 46); }
+    uint8 GetInstance() const { return static_cast<uint8>(m_id >> 38); }
+    uint16 GetIndex() const { return static_cast<uint16>(m_id >> 22); }
+    ValueType GetType() const { return static_cast<ValueType>(m_id & 0x0f); }
+    uint64 GetId() const { return m_id; }
+
+    bool operator==(const ValueID &other) const { return m_homeId == other.m_homeId && m_id == other.m_id; }
+    bool operator<(const ValueID &other) const { return m_homeId < other.m_homeId || (m_homeId == other.m_homeId && m_id < other.m_id); }
+
+private:
+    uint32 m_homeId = 0;
+    uint64 m_id = 0;
+};
+
+}
+
+#endif // OPENZWAVESTUB_VALUEID_H
@@ -0,0 +1,896 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+*
+* Copyright (C) 2013 - 2024, nymea GmbH
+* Copyright (C) 2024 - 2025, chargebyte austria GmbH
+*
+* This file is part of nymea-zwave-plugin-openzwave.
+*
+* nymea-zwave-plugin-openzwave is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* nymea-zwave-plugin-openzwave is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with nymea-zwave-plugin-openzwave. If not, see <https://www.gnu.org/licenses/>.
+*
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "openzwavestub.h"
+#include "Options.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+using namespace OpenZWave;
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+struct StubController
+{
+    uint32 homeId = 0;
+    int readyDelay = 0;
+    uint8 nodeId = 1;
+};
+
+struct StubNode
+{
+    std::string name;
+    bool listening = true;
+};
+
+struct StubValue
+{
+    int32 number = 0;
+    std::string string;
+    std::vector<std::string> items;
+    std::vector<int32> itemValues;
+    bool polled = false;
+    uint8 intensity = 0;
+};
+
+struct PendingNotification
+{
+    Notification notification;
+    bool increment;
+};
+
+class Stub
+{
+public:
+    ~Stub() {
+        stopThread();
+    }
+
+    void startThread() {
+        std::lock_guard<std::mutex> locker(mutex);
+        if (thread.joinable()) {
+            return;
+        }
+        stop = false;
+        thread = std::thread(&Stub::run, this);
+    }
+
+    void stopThread() {
+        {
+            std::lock_guard<std::mutex> locker(mutex);
+            stop = true;
+        }
+        condition.notify_all();
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+
+    void post(const Notification &notification, Clock::time_point due, bool increment) {
+        PendingNotification pendingNotification = { notification, increment };
+        pending.insert(std::make_pair(due, pendingNotification));
+        condition.notify_all();
+    }
+
+    // Called with the mutex locked
+    StubValue *value(const ValueID &valueId) {
+        std::map<std::pair<uint32, uint64>, StubValue>::iterator it = values.find(std::make_pair(valueId.GetHomeId(), valueId.GetId()));
+        return it != values.end() ? &it->second : nullptr;
+    }
+    StubNode *node(uint32 homeId, uint8 nodeId) {
+        std::map<std::pair<uint32, uint8>, StubNode>::iterator it = nodes.find(std::make_pair(homeId, nodeId));
+        return it != nodes.end() ? &it->second : nullptr;
+    }
+
+    std::mutex mutex;
+    std::condition_variable condition;
+
+    std::map<std::string, StubController> controllers;
+    std::map<std::pair<uint32, uint8>, StubNode> nodes;
+    std::map<std::pair<uint32, uint64>, StubValue> values;
+    std::multimap<Clock::time_point, PendingNotification> pending;
+    std::vector<std::pair<Manager::pfnOnNotification_t, void*> > watchers;
+    int32 sendQueueCount = 0;
+    int32 pollInterval = 0;
+    uint64 delivered = 0;
+    bool delivering = false;
+
+    Manager *manager = nullptr;
+    Options *options = nullptr;
+
+private:
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!stop) {
+            if (pending.empty()) {
+                condition.wait(lock);
+                continue;
+            }
+            std::multimap<Clock::time_point, PendingNotification>::iterator it = pending.begin();
+            if (it->first > Clock::now()) {
+                condition.wait_until(lock, it->first);
+                continue;
+            }
+            PendingNotification next = it->second;
+            pending.erase(it);
+            if (next.increment) {
+                StubValue *stubValue = value(next.notification.GetValueID());
+                if (stubValue) {
+                    stubValue->number++;
+                }
+            }
+            std::vector<std::pair<Manager::pfnOnNotification_t, void*> > currentWatchers = watchers;
+            delivering = true;
+
+            // Like OpenZWave, watchers are called without holding any lock
+            lock.unlock();
+            for (size_t i = 0; i < currentWatchers.size(); i++) {
+                currentWatchers.at(i).first(&next.notification, currentWatchers.at(i).second);
+            }
+            lock.lock();
+
+            delivering = false;
+            delivered++;
+            condition.notify_all();
+        }
+    }
+
+    std::thread thread;
+    bool stop = false;
+};
+
+Stub &stub()
+{
+    static Stub instance;
+    return instance;
+}
+
+}
+
+// Options
+
+Options *Options::Create(const std::string &configPath, const std::string &userPath, const std::string &commandLine)
+{
+    (void)configPath;
+    (void)userPath;
+    (void)commandLine;
+    std::lock_guard<std::mutex> locker(stub().mutex);
+    if (!stub().options) {
+        stub().options = new Options();
+    }
+    return stub().options;
+}
+
+bool Options::Destroy()
+{
+    std::lock_guard<std::mutex> locker(stub().mutex);
+    delete stub().options;
+    stub().options = nullptr;
+    return true;
+}
+
+Options *Options::Get()
+{
+    return stub().options;
+}
+
+bool Options::Lock()
+{
+    m_locked = true;
+    return true;
+}
+
+bool Options::AddOptionBool(const std::string &name, bool value)
+{
+    m_options[name] = value ? "true" : "false";
+    return !m_locked;
+}
+
+bool Options::AddOptionInt(const std::string &name, int32 value)
+{
+    std::ostringstream stream;
+    stream << value;
+    m_options[name] = stream.str();
+    if (name == "PollInterval") {
+        std::lock_guard<std::mutex> locker(stub().mutex);
+        stub().pollInterval = value;
+    }
+    return !m_locked;
+}
+
+bool Options::AddOptionString(const std::string &name, const std::string &value, bool append)
+{
+    (void)append;
+    m_options[name] = value;
+    return !m_locked;
+}
+
+std::string Options::GetOption(const std::string &name) const
+{
+    std::map<std::string, std::string>::const_iterator it = m_options.find(name);
+    return it != m_options.end() ? it->second : std::string();
+}
+
+// Manager
+
+Manager *Manager::Create()
+{
+    {
+        std::lock_guard<std::mutex> locker(stub().mutex);
+        if (!stub().manager) {
+            stub().manager = new Manager();
+        }
+    }
+    stub().startThread();
+    return stub().manager;
+}
+
+Manager *Manager::Get()
+{
+    return stub().manager;
+}
+
+void Manager::Destroy()
+{
+    stub().stopThread();
+    std::lock_guard<std::mutex> locker(stub().mutex);
+    stub().watchers.clear();
+    stub().pending.clear();
+    delete stub().manager;
+    stub().manager = nullptr;
+}
+
+bool Manager::AddWatcher(pfnOnNotification_t watcher, void *context)
+{
+    std::lock_guard<std::mutex> locker(stub().mutex);
+    stub().watchers.push_back(std::make_pair(watcher, context));
+    return true;
+}
+
+bool Manager::RemoveWatcher(pfnOnNotification_t watcher, void *context)
+{
+    std::lock_guard<std::mutex> locker(stub().mutex);
+    std::vector<std::pair<pfnOnNotification_t, void*> > &watchers = stub().watchers;
+    for (size_t i = 0; i < watchers.size(); i++) {
+        if (watchers.at(i).first == watcher && watchers.at(i).second == context) {
+            watchers.erase(watchers.begin() + i);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Manager::AddDriver(const std::string &controllerPath, const Driver::ControllerInterface &interface)
+{
+    (void)interface;
+    std::lock_guard<std::mutex> locker(stub().mutex);
+    std::map<std::string, StubController>::const_iterator it = stub().controllers.find(controllerPath);
+    if (it == stub().controllers.end()) {
+        Notification notification(Notification::Type_DriverFailed);
+        notification.SetComPort(controllerPath);
+        stub().post(notification, Clock::now(), false);
+        return true;
+    }
+    Notification notification(Notification::Type_DriverReady);
+    notification.SetHomeAndNodeIds(it->second.homeId, it->second.nodeId);
+    stub().post(notification, Clock::now() + std::chrono::milliseconds(it->second.readyDelay), false);
+    return true;
+}
+
+bool Manager::RemoveDriver(const std::string &controllerPath)
+{
+    std::lock_guard<std::mutex> locker(stub().mutex);
+    std::map<std::string, StubController>::const_iterator it = stub().controllers.find(controllerPath);
+    if (it == stub().controllers.end()) {
+        return false;
+    }
+    Notification notification(Notification::Type_DriverRemoved);
+    notification.SetHomeAndNodeIds(it->second.homeId, 0);
+    stub().post(notification, Clock::now(), false);
+    return true;
+}
+
+uint8 Manager::GetControllerNodeId(uint32 homeId)
+{
+    std::lock_guard<std::mutex> locker(stub().mutex);
+    for (std::map<std::string, StubController>::const_iterator it = stub().controllers.begin(); it != stub().controllers.end(); ++it) {
+        if (it->second.homeId == homeId) {
+            return it->second.nodeId;
+        }
+    }
+    return 0;
+}
+
+bool Manager::IsPrimaryController(uint32 homeId)
+{
+    return GetControllerNodeId(homeId) != 0;
+}
+
+bool Manager::IsStaticUpdateController(uint32 homeId)
+{
+    return GetControllerNodeId(homeId) != 0;
+}
+
+bool Manager::IsBridgeController(uint32 homeId)
+{
+    (void)homeId;
+    return false;
+}
+
+bool Manager::HasExtendedTxStatus(uint32 homeId)
+{
+    (void)homeId;
+    return false;
+}
+
+std::string Manager::GetControllerPath(uint32 homeId)
+{
+    std::lock_guard<std::mutex> locker(stub().mutex);
+    for (std::map<std::string, StubController>::const_iterator it = stub().controllers.begin(); it != stub().controllers.end(); ++it) {
+        if (it->second.homeId == homeId) {
+            return it->first;
+        }
+    }
+    return std::string();
+}
+
+int32 Manager::GetSendQueueCount(uint32 homeId)
+{
+    (void)homeId;
+    std::lock_guard<std::mutex> locker(stub().mutex);
+    return stub().sendQueueCount;
+}
+
+void Manager::GetDriverStatistics(uint32 homeId, Driver::DriverData *data)
+{
+    (void)homeId;
+    *data = Driver::DriverData();
+}
+
+void Manager::GetNodeStatistics(uint32 homeId, uint8 nodeId, Node::NodeData *data)
+{
+    (void)homeId;
+    (void)nodeId;
+    *data = Node::NodeData();
+}
+
+void Manager::ResetController(uint32 homeId)
+{
+    // Comes up again with a new home id, like a real controller does
+    std::lock_guard<std::mutex> locker(stub().mutex);
+    for (std::map<std::string, StubController>::iterator it = stub().controllers.begin(); it != stub().controllers.end(); ++it) {
+        if (it->second.homeId == homeId) {
+            it->second.homeId = homeId + 1;
+            Notification notification(Notification::Type_DriverReady);
+            notification.SetHomeAndNodeIds(it->second.homeId, it->second.nodeId);
+            stub().post(notification, Clock::now() + std::chrono::milliseconds(it->second.readyDelay), false);
+            return;
+        }
+    }
+}
+
+bool Manager::AddNode(uint32 homeId, bool doSecurity)
+{
+    (void)doSecurity;
+    return GetControllerNodeId(homeId) != 0;
+}
+
+bool Manager::RemoveNode(uint32 homeId)
+{
+    return GetControllerNodeId(homeId) != 0;
+}
+
+bool Manager::RemoveFailedNode(uint32 homeId, uint8 nodeId)
+{
+    (void)nodeId;
+    return GetControllerNodeId(homeId) != 0;
+}
+
+bool Manager::CancelControllerCommand(uint32 homeId)
+{
+    return GetControllerNodeId(homeId) != 0;
+}
+
+void Manager::HealNetworkNode(uint32 homeId, uint8 nodeId, bool doRR)
+{
+    (void)homeId;
+    (void)nodeId;
+    (void)doRR;
+}
+
+void Manager::SetPollInterval(int32 milliseconds, bool intervalBetweenPolls)
+{
+    (void)intervalBetweenPolls;
+    std::lock_guard<std::mutex> locker(stub().mutex);
+    stub().pollInterval = milliseconds;
+}
+
+bool Manager::IsPolled(const ValueID &valueId)
+{
+    std::lock_guard<std::mutex> locker(stub().mutex);
+    StubValue *value = stub().value(valueId);
+    return value && value->polled;
+}
+
+void Manager::SetPollIntensity(const ValueID &valueId, uint8 intensity)
+{
+    std::lock_guard<std::mutex> locker(stub().mutex);
+    StubValue *value = stub().value(valueId);
+    if (value) {
+        value->intensity = intensity;
+    }
+}
+
+uint8 Manager::GetPollIntensity(const ValueID &valueId)
+{
+    std::lock_guard<std::mutex> locker(stub().mutex);
+    StubValue *value = stub().value(valueId);
+    return value ? value->intensity : 0;
+}
+
+bool Manager::IsNodeListeningDevice(uint32 homeId, uint8 nodeId)
+{
+    std::lock_guard<std::mutex> locker(stub().mutex);
+    StubNode *node = stub().node(homeId, nodeId);
+    return node && node->listening;
+}
+
+bool Manager::IsNodeFrequentListeningDevice(uint32 homeId, uint8 nodeId)
+{
+    (void)homeId;
+    (void)nodeId;
+    return false;
+}
+
+bool Manager::IsNodeBeamingDevice(uint32 homeId, uint8 nodeId)
+{
+    (void)homeId;
+    (void)nodeId;
+    return false;
+}
+
+bool Manager::IsNodeAwake(uint32 homeId, uint8 nodeId)
+{
+    return IsNodeListeningDevice(homeId, nodeId);
+}
+
+bool Manager::IsNodeFailed(uint32 homeId, uint8 nodeId)
+{
+    (void)homeId;
+    (void)nodeId;
+    return false;
+}
+
+bool Manager::IsNodeZWavePlus(uint32 homeId, uint8 nodeId)
+{
+    (void)homeId;
+    (void)nodeId;
+    return true;
+}
+
+uint8 Manager::GetNodeBasic(uint32 homeId, uint8 nodeId)
+{
+    (void)homeId;
+    (void)nodeId;
+    return 0x04;
+}
+
+uint16 Manager::GetNodeDeviceType(uint32 homeId, uint8 nodeId)
+{
+    (void)homeId;
+    (void)nodeId;
+    return 0x1001;
+}
+
+uint8 Manager::GetNodeRole(uint32 homeId, uint8 nodeId)
+{
+    (void)homeId;
+    (void)nodeId;
+    return 0x05;
+}
+
+uint8 Manager::GetNodePlusType(uint32 homeId, uint8 nodeId)
+{
+    (void)homeId;
+    (void)nodeId;
+    return 0;
+}
+
+uint8 Manager::GetNodeSecurity(uint32 homeId, uint8 nodeId)
+{
+    (void)homeId;
+    (void)nodeId;
+    return 0;
+}
+
+uint8 Manager::GetNodeVersion(uint32 homeId, uint8 nodeId)
+{
+    (void)homeId;
+    (void)nodeId;
+    return 4;
+}
+
+std::string Manager::GetNodeName(uint32 homeId, uint8 nodeId)
+{
+    std::lock_guard<std::mutex> locker(stub().mutex);
+    StubNode *node = stub().node(homeId, nodeId);
+    return node ? node->name : std::string();
+}
+
+std::string Manager::GetNodeManufacturerName(uint32 homeId, uint8 nodeId)
+{
+    (void)homeId;
+    (void)nodeId;
+    return "Stub Manufacturer";
+}
+
+std::string Manager::GetNodeProductName(uint32 homeId, uint8 nodeId)
+{
+    (void)homeId;
+    (void)nodeId;
+    return "Stub Product";
+}
+
+std::string Manager::GetNodeManufacturerId(uint32 homeId, uint8 nodeId)
+{
+    (void)homeId;
+    (void)nodeId;
+    return "0x0086";
+}
+
+std::string Manager::GetNodeProductType(uint32 homeId, uint8 nodeId)
+{
+    (void)homeId;
+    (void)nodeId;
+    return "0x0003";
+}
+
+std::string Manager::GetNodeProductId(uint32 homeId, uint8 nodeId)
+{
+    (void)homeId;
+    (void)nodeId;
+    return "0x0060";
+}
+
+std::string Manager::GetValueHelp(const ValueID &valueId)
+{
+    (void)valueId;
+    return "Stub value";
+}
+
+std::string Manager::GetValueUnits(const ValueID &valueId)
+{
+    (void)valueId;
+    return std::string();
+}
+
+int32 Manager::GetValueMin(const ValueID &valueId)
+{
+    (void)valueId;
+    return 0;
+}
+
+int32 Manager::GetValueMax(const ValueID &valueId)
+{
+    (void)valueId;
+    return 255;
+}
+
+bool Manager::GetValueAsBool(const ValueID &valueId, bool *value)
+{
+    std::lock_guard<std::mutex> locker(stub().mutex);
+    StubValue *stubValue = stub().value(valueId);
+    *value = stubValue && (stubValue->number % 2) != 0;
+    return stubValue != nullptr;
+}
+
+bool Manager::GetValueAsByte(const ValueID &valueId, uint8 *value)
+{
+    std::lock_guard<std::mutex> locker(stub().mutex);
+    StubValue *stubValue = stub().value(valueId);
+    *value = stubValue ? static_cast<uint8>(stubValue->number) : 0;
+    return stubValue != nullptr;
+}
+
+bool Manager::GetValueAsFloat(const ValueID &valueId, float *value)
+{
+    std::lock_guard<std::mutex> locker(stub().mutex);
+    StubValue *stubValue = stub().value(valueId);
+    *value = stubValue ? stubValue->number / 10.0f : 0;
+    return stubValue != nullptr;
+}
+
+bool Manager::GetValueAsInt(const ValueID &valueId, int32 *value)
+{
+    std::lock_guard<std::mutex> locker(stub().mutex);
+    StubValue *stubValue = stub().value(valueId);
+    *value = stubValue ? stubValue->number : 0;
+    return stubValue != nullptr;
+}
+
+bool Manager::GetValueAsShort(const ValueID &valueId, int16 *value)
+{
+    std::lock_guard<std::mutex> locker(stub().mutex);
+    StubValue *stubValue = stub().value(valueId);
+    *value = stubValue ? static_cast<int16>(stubValue->number) : 0;
+    return stubValue != nullptr;
+}
+
+bool Manager::GetValueAsString(const ValueID &valueId, std::string *value)
+{
+    std::lock_guard<std::mutex> locker(stub().mutex);
+    StubValue *stubValue = stub().value(valueId);
+    *value = stubValue ? stubValue->string : std::string();
+    return stubValue != nullptr;
+}
+
+bool Manager::GetValueListSelection(const ValueID &valueId, std::string *value)
+{
+    std::lock_guard<std::mutex> locker(stub().mutex);
+    StubValue *stubValue = stub().value(valueId);
+    value->clear();
+    if (!stubValue) {
+        return false;
+    }
+    for (size_t i = 0; i < stubValue->itemValues.size() && i < stubValue->items.size(); i++) {
+        if (stubValue->itemValues.at(i) == stubValue->number) {
+            *value = stubValue->items.at(i);
+        }
+    }
+    return true;
+}
+
+bool Manager::GetValueListSelection(const ValueID &valueId, int32 *value)
+{
+    return GetValueAsInt(valueId, value);
+}
+
+bool Manager::GetValueListItems(const ValueID &valueId, std::vector<std::string> *items)
+{
+    std::lock_guard<std::mutex> locker(stub().mutex);
+    StubValue *stubValue = stub().value(valueId);
+    *items = stubValue ? stubValue->items : std::vector<std::string>();
+    return stubValue != nullptr;
+}
+
+bool Manager::GetValueListValues(const ValueID &valueId, std::vector<int32> *values)
+{
+    std::lock_guard<std::mutex> locker(stub().mutex);
+    StubValue *stubValue = stub().value(valueId);
+    *values = stubValue ? stubValue->itemValues : std::vector<int32>();
+    return stubValue != nullptr;
+}
+
+// Writes are confirmed by the device right away: the message completes and the value is reported
+static bool setValue(const ValueID &valueId, int32 number, const std::string *string)
+{
+    std::lock_guard<std::mutex> locker(stub().mutex);
+    StubValue *stubValue = stub().value(valueId);
+    if (!stubValue) {
+        return false;
+    }
+    stubValue->number = number;
+    if (string) {
+        stubValue->string = *string;
+    }
+    Notification completed(Notification::Type_Notification);
+    completed.SetHomeAndNodeIds(valueId.GetHomeId(), valueId.GetNodeId());
+    completed.SetNotification(Notification::Code_MsgComplete);
+    stub().post(completed, Clock::now(), false);
+    Notification changed(Notification::Type_ValueChanged);
+    changed.SetValueId(valueId);
+    stub().post(changed, Clock::now(), false);
+    return true;
+}
+
+bool Manager::SetValue(const ValueID &valueId, bool value)
+{
+    return setValue(valueId, value ? 1 : 0, nullptr);
+}
+
+bool Manager::SetValue(const ValueID &valueId, uint8 value)
+{
+    return setValue(valueId, value, nullptr);
+}
+
+bool Manager::SetValue(const ValueID &valueId, float value)
+{
+    return setValue(valueId, static_cast<int32>(value * 10), nullptr);
+}
+
+bool Manager::SetValue(const ValueID &valueId, int32 value)
+{
+    return setValue(valueId, value, nullptr);
+}
+
+bool Manager::SetValue(const ValueID &valueId, int16 value)
+{
+    return setValue(valueId, value, nullptr);
+}
+
+bool Manager::SetValue(const ValueID &valueId, const std::string &value)
+{
+    return setValue(valueId, 0, &value);
+}
+
+bool Manager::SetValueListSelection(const ValueID &valueId, const std::string &selectedItem)
+{
+    int32 number = 0;
+    {
+        std::lock_guard<std::mutex> locker(stub().mutex);
+        StubValue *stubValue = stub().value(valueId);
+        if (!stubValue) {
+            return false;
+        }
+        size_t i = 0;
+        while (i < stubValue->items.size() && stubValue->items.at(i) != selectedItem) {
+            i++;
+        }
+        if (i >= stubValue->items.size() || i >= stubValue->itemValues.size()) {
+            return false;
+        }
+        number = stubValue->itemValues.at(i);
+    }
+    return setValue(valueId, number, nullptr);
+}
+
+bool Manager::PressButton(const ValueID &valueId)
+{
+    return setValue(valueId, 1, nullptr);
+}
+
+bool Manager::ReleaseButton(const ValueID &valueId)
+{
+    return setValue(valueId, 0, nullptr);
+}
+
+bool Manager::RefreshValue(const ValueID &valueId)
+{
+    std::lock_guard<std::mutex> locker(stub().mutex);
+    if (!stub().value(valueId)) {
+        return false;
+    }
+    Notification refreshed(Notification::Type_ValueRefreshed);
+    refreshed.SetValueId(valueId);
+    stub().post(refreshed, Clock::now(), false);
+    return true;
+}
+
+// Control functions
+
+void OpenZWaveStub::reset()
+{
+    std::lock_guard<std::mutex> locker(stub().mutex);
+    stub().controllers.clear();
+    stub().nodes.clear();
+    stub().values.clear();
+    stub().pending.clear();
+    stub().sendQueueCount = 0;
+}
+
+void OpenZWaveStub::addController(const std::string &port, uint32 homeId, int readyDelay, uint8 nodeId)
+{
+    std::lock_guard<std::mutex> locker(stub().mutex);
+    StubController controller;
+    controller.homeId = homeId;
+    controller.readyDelay = readyDelay;
+    controller.nodeId = nodeId;
+    stub().controllers[port] = controller;
+}
+
+void OpenZWaveStub::addNode(uint32 homeId, uint8 nodeId, const std::string &name, bool listening)
+{
+    std::lock_guard<std::mutex> locker(stub().mutex);
+    StubNode node;
+    node.name = name;
+    node.listening = listening;
+    stub().nodes[std::make_pair(homeId, nodeId)] = node;
+}
+
+void OpenZWaveStub::addValue(const ValueID &valueId, int32 value, bool polled)
+{
+    std::lock_guard<std::mutex> locker(stub().mutex);
+    StubValue stubValue;
+    stubValue.number = value;
+    stubValue.polled = polled;
+    stubValue.intensity = polled ? 1 : 0;
+    stub().values[std::make_pair(valueId.GetHomeId(), valueId.GetId())] = stubValue;
+}
+
+void OpenZWaveStub::addListValue(const ValueID &valueId, const std::vector<std::string> &items, const std::vector<int32> &values, int32 selection)
+{
+    std::lock_guard<std::mutex> locker(stub().mutex);
+    StubValue stubValue;
+    stubValue.number = selection;
+    stubValue.items = items;
+    stubValue.itemValues = values;
+    stub().values[std::make_pair(valueId.GetHomeId(), valueId.GetId())] = stubValue;
+}
+
+void OpenZWaveStub::addStringValue(const ValueID &valueId, const std::string &value)
+{
+    std::lock_guard<std::mutex> locker(stub().mutex);
+    StubValue stubValue;
+    stubValue.string = value;
+    stub().values[std::make_pair(valueId.GetHomeId(), valueId.GetId())] = stubValue;
+}
+
+void OpenZWaveStub::setSendQueueCount(int32 count)
+{
+    std::lock_guard<std::mutex> locker(stub().mutex);
+    stub().sendQueueCount = count;
+}
+
+std::string OpenZWaveStub::option(const std::string &name)
+{
+    std::lock_guard<std::mutex> locker(stub().mutex);
+    return stub().options ? stub().options->GetOption(name) : std::string();
+}
+
+int32 OpenZWaveStub::pollInterval()
+{
+    std::lock_guard<std::mutex> locker(stub().mutex);
+    return stub().pollInterval;
+}
+
+void OpenZWaveStub::post(const Notification &notification, int delay)
+{
+    std::lock_guard<std::mutex> locker(stub().mutex);
+    stub().post(notification, Clock::now() + std::chrono::milliseconds(delay), false);
+}
+
+void OpenZWaveStub::generate(const Notification &notification, int count, int rate)
+{
+    bool increment = notification.GetType() == Notification::Type_ValueChanged || notification.GetType() == Notification::Type_ValueRefreshed;
+    std::lock_guard<std::mutex> locker(stub().mutex);
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < count; i++) {
+        Clock::time_point due = start;
+        if (rate > 0) {
+            due += std::chrono::microseconds(static_cast<int64>(i) * 1000000 / rate);
+        }
+        stub().post(notification, due, increment);
+    }
+}
+
+bool OpenZWaveStub::waitForIdle(int timeout)
+{
+    std::unique_lock<std::mutex> lock(stub().mutex);
+    return stub().condition.wait_for(lock, std::chrono::milliseconds(timeout), [](){
+        return stub().pending.empty() && !stub().delivering;
+    });
+}
+
+uint64 OpenZWaveStub::delivered()
+{
+    std::lock_guard<std::mutex> locker(stub().mutex);
+    return stub().delivered;
+}
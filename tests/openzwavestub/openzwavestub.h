@@ -0,0 +1,61 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+*
+* Copyright (C) 2013 - 2024, nymea GmbH
+* Copyright (C) 2024 - 2025, chargebyte austria GmbH
+*
+* This file is part of nymea-zwave-plugin-openzwave.
+*
+* nymea-zwave-plugin-openzwave is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* nymea-zwave-plugin-openzwave is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with nymea-zwave-plugin-openzwave. If not, see <https://www.gnu.org/licenses/>.
+*
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef OPENZWAVESTUB_H
+#define OPENZWAVESTUB_H
+
+#include "Manager.h"
+
+// Sets up the network the stub Manager answers from and drives its notification thread.
+// The setup functions are meant to be called while no notifications are being delivered.
+namespace OpenZWaveStub {
+
+// Forgets all controllers, nodes and values and drops notifications not delivered yet
+void reset();
+
+// AddDriver() for the port brings up a driver with the home id after readyDelay ms. Ports not added here fail.
+void addController(const std::string &port, uint32 homeId, int readyDelay = 0, uint8 nodeId = 1);
+void addNode(uint32 homeId, uint8 nodeId, const std::string &name = std::string(), bool listening = true);
+void addValue(const OpenZWave::ValueID &valueId, int32 value = 0, bool polled = false);
+void addListValue(const OpenZWave::ValueID &valueId, const std::vector<std::string> &items, const std::vector<int32> &values, int32 selection);
+void addStringValue(const OpenZWave::ValueID &valueId, const std::string &value);
+void setSendQueueCount(int32 count);
+
+// What the backend configured, empty if the option hasn't been set
+std::string option(const std::string &name);
+int32 pollInterval();
+
+// Delivers the notification to the watchers after delay ms
+void post(const OpenZWave::Notification &notification, int delay = 0);
+// Delivers count copies at the given rate per second, 0 delivers them as fast as the watchers take them.
+// ValueChanged and ValueRefreshed notifications increment the value before delivering it.
+void generate(const OpenZWave::Notification &notification, int count, int rate = 0);
+
+// Waits until all posted notifications have been delivered
+bool waitForIdle(int timeout = 30000);
+uint64 delivered();
+
+}
+
+#endif // OPENZWAVESTUB_H
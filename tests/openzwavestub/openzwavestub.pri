@@ -0,0 +1,18 @@
+# Stands in for libopenzwave, see openzwavestub.h
+INCLUDEPATH += $$PWD
+
+SOURCES += \
+    $$PWD/openzwavestub.cpp
+
+HEADERS += \
+    $$PWD/Defs.h \
+    $$PWD/Driver.h \
+    $$PWD/Manager.h \
+    $$PWD/Node.h \
+    $$PWD/Notification.h \
+    $$PWD/OZWException.h \
+    $$PWD/Options.h \
+    $$PWD/Utils.h \
+    $$PWD/ValueID.h \
+    $$PWD/openzwavestub.h \
+    $$PWD/platform/Log.h
@@ -0,0 +1,68 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+*
+* Copyright (C) 2013 - 2024, nymea GmbH
+* Copyright (C) 2024 - 2025, chargebyte austria GmbH
+*
+* This file is part of nymea-zwave-plugin-openzwave.
+*
+* nymea-zwave-plugin-openzwave is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* nymea-zwave-plugin-openzwave is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with nymea-zwave-plugin-openzwave. If not, see <https://www.gnu.org/licenses/>.
+*
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "openzwavetracereplay.h"
+#include "openzwavebackend.h"
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QDebug>
+
+// Replays a notification trace recorded with OpenZWaveBackend::startTrace() and prints the dispatch
+// statistics, e.g. to profile a notification storm from the field offline.
+int main(int argc, char *argv[])
+{
+    QCoreApplication application(argc, argv);
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    parser.addPositionalArgument("trace", "The notification trace to replay.");
+    QCommandLineOption speedOption(QStringList() << "s" << "speed", "Replay speed factor, 0 replays all notifications at once. Default: 1", "speed", "1");
+    parser.addOption(speedOption);
+    parser.process(application);
+
+    if (parser.positionalArguments().count() != 1) {
+        parser.showHelp(1);
+    }
+
+    OpenZWaveTraceReplay replay;
+    if (!replay.load(parser.positionalArguments().first())) {
+        qWarning() << "Cannot load trace" << parser.positionalArguments().first();
+        return 1;
+    }
+
+    QElapsedTimer timer;
+    QObject::connect(&replay, &OpenZWaveTraceReplay::finished, &application, [&](){
+        qInfo() << "Replayed" << replay.count() << "notifications in" << timer.elapsed() << "ms";
+        foreach (const QUuid &networkUuid, replay.networks()) {
+            qInfo() << "Network" << replay.backend()->homeId(networkUuid) << qPrintable(replay.backend()->dispatchStatistics(networkUuid).toString());
+        }
+        application.quit();
+    });
+    timer.start();
+    replay.start(parser.value(speedOption).toDouble());
+
+    return application.exec();
+}
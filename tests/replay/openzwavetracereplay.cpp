@@ -0,0 +1,185 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+*
+* Copyright (C) 2013 - 2024, nymea GmbH
+* Copyright (C) 2024 - 2025, chargebyte austria GmbH
+*
+* This file is part of nymea-zwave-plugin-openzwave.
+*
+* nymea-zwave-plugin-openzwave is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* nymea-zwave-plugin-openzwave is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with nymea-zwave-plugin-openzwave. If not, see <https://www.gnu.org/licenses/>.
+*
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "openzwavetracereplay.h"
+#include "openzwavetrace.h"
+#include "openzwavebackend.h"
+#include "openzwavestub.h"
+
+OpenZWaveTraceReplay::OpenZWaveTraceReplay(QObject *parent):
+    QObject(parent),
+    m_backend(new OpenZWaveBackend(this))
+{
+    m_backend->m_storagePath = m_storageDir.path() + "/";
+    connect(m_backend, &ZWaveBackend::networkStarted, this, &OpenZWaveTraceReplay::onNetworkStarted);
+
+    m_finishedTimer.setInterval(100);
+    connect(&m_finishedTimer, &QTimer::timeout, this, &OpenZWaveTraceReplay::checkFinished);
+}
+
+OpenZWaveTraceReplay::~OpenZWaveTraceReplay()
+{
+    foreach (const QUuid &networkUuid, m_networks) {
+        m_backend->stopNetwork(networkUuid);
+    }
+    delete m_backend;
+}
+
+bool OpenZWaveTraceReplay::load(const QString &fileName)
+{
+    // The stub network is built from the trace, so a replay can only be loaded once
+    if (!m_storageDir.isValid() || !m_records.isEmpty() || !OpenZWaveTrace::load(fileName, &m_records)) {
+        return false;
+    }
+
+    OpenZWaveStub::reset();
+    foreach (const OpenZWaveNotificationRecord &record, m_records) {
+        if (record.homeId == 0) {
+            continue;
+        }
+        if (!m_networks.contains(record.homeId)) {
+            QString serialPort = QString("/dev/ttyReplay%1").arg(m_networks.count());
+            m_networks.insert(record.homeId, QUuid::createUuid());
+            m_serialPorts.insert(record.homeId, serialPort);
+            OpenZWaveStub::addController(serialPort.toStdString(), record.homeId);
+        }
+        if (record.nodeId != 0) {
+            OpenZWaveStub::addNode(record.homeId, record.nodeId);
+        }
+        switch (record.type) {
+        case OpenZWave::Notification::Type_ValueAdded:
+        case OpenZWave::Notification::Type_ValueChanged:
+        case OpenZWave::Notification::Type_ValueRefreshed:
+            OpenZWaveStub::addValue(OpenZWave::ValueID(record.homeId, record.valueId));
+            break;
+        default:
+            break;
+        }
+    }
+    return true;
+}
+
+int OpenZWaveTraceReplay::count() const
+{
+    return m_records.count();
+}
+
+void OpenZWaveTraceReplay::start(double speed)
+{
+    if (m_running) {
+        return;
+    }
+    m_speed = speed;
+    m_running = true;
+    m_pendingNetworks = m_networks.count();
+    if (m_pendingNetworks == 0) {
+        post();
+        return;
+    }
+    foreach (quint32 homeId, m_networks.keys()) {
+        m_backend->startNetwork(m_networks.value(homeId), m_serialPorts.value(homeId));
+    }
+}
+
+bool OpenZWaveTraceReplay::isRunning() const
+{
+    return m_running;
+}
+
+OpenZWaveBackend *OpenZWaveTraceReplay::backend() const
+{
+    return m_backend;
+}
+
+QList<QUuid> OpenZWaveTraceReplay::networks() const
+{
+    return m_networks.values();
+}
+
+void OpenZWaveTraceReplay::onNetworkStarted(const QUuid &networkUuid)
+{
+    Q_UNUSED(networkUuid)
+    if (m_running && --m_pendingNetworks == 0) {
+        post();
+    }
+}
+
+void OpenZWaveTraceReplay::post()
+{
+    if (m_records.isEmpty()) {
+        m_running = false;
+        emit finished();
+        return;
+    }
+
+    quint64 first = m_records.first().timestamp;
+    foreach (const OpenZWaveNotificationRecord &record, m_records) {
+        OpenZWave::Notification notification(static_cast<OpenZWave::Notification::NotificationType>(record.type));
+        notification.SetHomeAndNodeIds(record.homeId, record.nodeId);
+        switch (record.type) {
+        case OpenZWave::Notification::Type_DriverReady:
+        case OpenZWave::Notification::Type_DriverFailed:
+        case OpenZWave::Notification::Type_DriverRemoved:
+            continue;
+        case OpenZWave::Notification::Type_ValueAdded:
+        case OpenZWave::Notification::Type_ValueChanged:
+        case OpenZWave::Notification::Type_ValueRefreshed:
+        case OpenZWave::Notification::Type_ValueRemoved:
+            notification.SetValueId(OpenZWave::ValueID(record.homeId, record.valueId));
+            break;
+        case OpenZWave::Notification::Type_Notification:
+            notification.SetNotification(record.code);
+            break;
+        case OpenZWave::Notification::Type_ControllerCommand:
+            notification.SetCommand(record.command);
+            notification.SetEvent(record.code);
+            break;
+        case OpenZWave::Notification::Type_NodeEvent:
+            notification.SetEvent(record.code);
+            break;
+        case OpenZWave::Notification::Type_UserAlerts:
+            notification.SetUserAlertType(static_cast<OpenZWave::Notification::UserAlertNotification>(record.code));
+            break;
+        default:
+            break;
+        }
+        int delay = m_speed > 0 ? static_cast<int>((record.timestamp - first) / 1000 / m_speed) : 0;
+        OpenZWaveStub::post(notification, delay);
+    }
+    m_finishedTimer.start();
+}
+
+void OpenZWaveTraceReplay::checkFinished()
+{
+    // Everything has been delivered by the stub. The last drain of the backend is already posted, so it runs
+    // before finished() is emitted.
+    if (!OpenZWaveStub::waitForIdle(0)) {
+        return;
+    }
+    m_finishedTimer.stop();
+    QTimer::singleShot(0, this, [this](){
+        m_running = false;
+        emit finished();
+    });
+}
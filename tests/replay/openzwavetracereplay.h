@@ -0,0 +1,87 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+*
+* Copyright (C) 2013 - 2024, nymea GmbH
+* Copyright (C) 2024 - 2025, chargebyte austria GmbH
+*
+* This file is part of nymea-zwave-plugin-openzwave.
+*
+* nymea-zwave-plugin-openzwave is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* nymea-zwave-plugin-openzwave is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with nymea-zwave-plugin-openzwave. If not, see <https://www.gnu.org/licenses/>.
+*
+* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef OPENZWAVETRACEREPLAY_H
+#define OPENZWAVETRACEREPLAY_H
+
+#include "openzwavenotificationqueue.h"
+
+#include <QObject>
+#include <QVector>
+#include <QTimer>
+#include <QTemporaryDir>
+#include <QHash>
+#include <QUuid>
+
+class OpenZWaveBackend;
+
+// Feeds a recorded trace into a backend of its own, built against the OpenZWave stub. The records are posted
+// as notifications on the stub's notification thread, so they reach the backend through the OpenZWave
+// callback and its queue keeps a single producer. The original timing is kept, scaled by the speed factor.
+// A speed of 0 posts all records at once.
+//
+// Every home id of the trace gets a stub controller and a network, started before the replay. The driver
+// notifications of the trace are skipped, the replay brings the drivers up and down itself. Nodes and values
+// of the trace are added to the stub, so reading them works, but they keep their initial value.
+class OpenZWaveTraceReplay : public QObject
+{
+    Q_OBJECT
+public:
+    explicit OpenZWaveTraceReplay(QObject *parent = nullptr);
+    ~OpenZWaveTraceReplay();
+
+    bool load(const QString &fileName);
+    int count() const;
+
+    void start(double speed = 1);
+    bool isRunning() const;
+
+    OpenZWaveBackend *backend() const;
+    QList<QUuid> networks() const;
+
+signals:
+    void finished();
+
+private slots:
+    void onNetworkStarted(const QUuid &networkUuid);
+    void checkFinished();
+
+private:
+    void post();
+
+    // Keeps the snapshots and OpenZWave files away from the real storage path
+    QTemporaryDir m_storageDir;
+    OpenZWaveBackend *m_backend = nullptr;
+    QVector<OpenZWaveNotificationRecord> m_records;
+    // Per home id of the trace
+    QHash<quint32, QUuid> m_networks;
+    QHash<quint32, QString> m_serialPorts;
+    int m_pendingNetworks = 0;
+    double m_speed = 1;
+    bool m_running = false;
+
+    QTimer m_finishedTimer;
+};
+
+#endif // OPENZWAVETRACEREPLAY_H